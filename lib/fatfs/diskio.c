@@ -1,93 +1,239 @@
 /*-----------------------------------------------------------------------*/
-/* Low level disk I/O module SKELETON for FatFs     (C)ChaN, 2019        */
+/* Low level disk I/O module for FatFs: SD card over SPI (RP2350)        */
 /*-----------------------------------------------------------------------*/
-/* If a working storage control module is available, it should be        */
-/* attached to the FatFs via a glue function rather than modifying it.   */
-/* This is an example of glue functions to attach various exsisting      */
-/* storage control modules to the FatFs module with a defined API.       */
+/* 只有一个物理驱动器 0：SD 卡接 SPI0，SCK GP18，MOSI GP19，MISO GP20，   */
+/* CS GP21（软件控制）。按 SD 简化规范的 SPI 模式初始化，支持 SDv1、SDv2   */
+/* （含 SDHC/SDXC 的块寻址）和 MMC。调用者需保证同一时刻只有一个任务访问   */
+/* FatFs（FF_FS_REENTRANT 为 0，固件中只有解码任务和启动时的扫描使用）     */
 /*-----------------------------------------------------------------------*/
 
 #include "ff.h"			/* Obtains integer types */
 #include "diskio.h"		/* Declarations of disk functions */
-
-/* Definitions of physical drive number for each drive */
-#define DEV_RAM		0	/* Example: Map Ramdisk to physical drive 0 */
-#define DEV_MMC		1	/* Example: Map MMC/SD card to physical drive 1 */
-#define DEV_USB		2	/* Example: Map USB MSD to physical drive 2 */
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+
+#define SD_SPI			spi0
+#define SD_SCK_PIN		18
+#define SD_MOSI_PIN		19
+#define SD_MISO_PIN		20
+#define SD_CS_PIN		21
+#define SD_INIT_HZ		400000		/* 初始化阶段不超过400kHz */
+#define SD_FAST_HZ		25000000	/* 初始化完成后的默认速度模式上限 */
+
+/* MMC/SD 命令（ACMD 带 0x80 标记，发送前先发 CMD55） */
+#define CMD0	(0)			/* GO_IDLE_STATE */
+#define CMD1	(1)			/* SEND_OP_COND (MMC) */
+#define ACMD41	(0x80+41)	/* SEND_OP_COND (SDC) */
+#define CMD8	(8)			/* SEND_IF_COND */
+#define CMD9	(9)			/* SEND_CSD */
+#define CMD12	(12)		/* STOP_TRANSMISSION */
+#define CMD16	(16)		/* SET_BLOCKLEN */
+#define CMD17	(17)		/* READ_SINGLE_BLOCK */
+#define CMD18	(18)		/* READ_MULTIPLE_BLOCK */
+#define ACMD23	(0x80+23)	/* SET_WR_BLK_ERASE_COUNT (SDC) */
+#define CMD24	(24)		/* WRITE_BLOCK */
+#define CMD25	(25)		/* WRITE_MULTIPLE_BLOCK */
+#define CMD55	(55)		/* APP_CMD */
+#define CMD58	(58)		/* READ_OCR */
+
+/* 卡类型 */
+#define CT_MMC		0x01
+#define CT_SD1		0x02
+#define CT_SD2		0x04
+#define CT_BLOCK	0x08	/* 按块而不是按字节寻址 */
+
+static volatile DSTATUS Stat = STA_NOINIT;
+static BYTE CardType;
 
 
 /*-----------------------------------------------------------------------*/
-/* Get Drive Status                                                      */
+/* SPI 收发                                                              */
 /*-----------------------------------------------------------------------*/
 
-DSTATUS disk_status (
-	BYTE pdrv		/* Physical drive nmuber to identify the drive */
-)
+static BYTE xchg_spi (BYTE data)
 {
-	DSTATUS stat;
-	int result;
+	BYTE received;
+	spi_write_read_blocking(SD_SPI, &data, &received, 1);
+	return received;
+}
 
-	switch (pdrv) {
-	case DEV_RAM :
-		result = RAM_disk_status();
+static void rcvr_spi_multi (BYTE* buff, UINT count)
+{
+	spi_read_blocking(SD_SPI, 0xFF, buff, count);
+}
 
-		// translate the reslut code here
+#if FF_FS_READONLY == 0
+static void xmit_spi_multi (const BYTE* buff, UINT count)
+{
+	spi_write_blocking(SD_SPI, buff, count);
+}
+#endif
 
-		return stat;
+/* 等待卡空闲（MISO 保持高电平），超时返回 0 */
+static int wait_ready (UINT ms)
+{
+	const uint64_t until = time_us_64() + (uint64_t)ms * 1000;
+	BYTE d;
+	do {
+		d = xchg_spi(0xFF);
+	} while (d != 0xFF && time_us_64() < until);
+	return d == 0xFF;
+}
 
-	case DEV_MMC :
-		result = MMC_disk_status();
+static void sd_deselect (void)
+{
+	gpio_put(SD_CS_PIN, 1);
+	xchg_spi(0xFF);		/* 多发一个字节让卡释放 MISO */
+}
 
-		// translate the reslut code here
+static int sd_select (void)
+{
+	gpio_put(SD_CS_PIN, 0);
+	xchg_spi(0xFF);
+	if (wait_ready(500)) return 1;
+	sd_deselect();
+	return 0;
+}
 
-		return stat;
 
-	case DEV_USB :
-		result = USB_disk_status();
+/*-----------------------------------------------------------------------*/
+/* 数据块与命令                                                          */
+/*-----------------------------------------------------------------------*/
 
-		// translate the reslut code here
+static int rcvr_datablock (BYTE* buff, UINT btr)
+{
+	const uint64_t until = time_us_64() + 200000;
+	BYTE token;
+	do {
+		token = xchg_spi(0xFF);
+	} while (token == 0xFF && time_us_64() < until);
+	if (token != 0xFE) return 0;	/* 不是数据起始令牌 */
+	rcvr_spi_multi(buff, btr);
+	xchg_spi(0xFF);					/* 丢弃 CRC */
+	xchg_spi(0xFF);
+	return 1;
+}
 
-		return stat;
+#if FF_FS_READONLY == 0
+/* token 为 0xFE（单块）、0xFC（多块）或 0xFD（多块结束，不带数据） */
+static int xmit_datablock (const BYTE* buff, BYTE token)
+{
+	if (!wait_ready(500)) return 0;
+	xchg_spi(token);
+	if (token != 0xFD) {
+		xmit_spi_multi(buff, 512);
+		xchg_spi(0xFF);				/* 假 CRC */
+		xchg_spi(0xFF);
+		if ((xchg_spi(0xFF) & 0x1F) != 0x05) return 0;	/* 数据未被接受 */
 	}
-	return STA_NOINIT;
+	return 1;
+}
+#endif
+
+/* 返回 R1 响应，0xFF 表示卡未就绪 */
+static BYTE send_cmd (BYTE cmd, DWORD arg)
+{
+	BYTE n, res;
+
+	if (cmd & 0x80) {
+		cmd &= 0x7F;
+		res = send_cmd(CMD55, 0);
+		if (res > 1) return res;
+	}
+	if (cmd != CMD12) {
+		sd_deselect();
+		if (!sd_select()) return 0xFF;
+	}
+	xchg_spi(0x40 | cmd);
+	xchg_spi((BYTE)(arg >> 24));
+	xchg_spi((BYTE)(arg >> 16));
+	xchg_spi((BYTE)(arg >> 8));
+	xchg_spi((BYTE)arg);
+	n = 0x01;						/* 空 CRC 加停止位 */
+	if (cmd == CMD0) n = 0x95;		/* SPI 模式下只有这两条命令检查 CRC */
+	if (cmd == CMD8) n = 0x87;
+	xchg_spi(n);
+	if (cmd == CMD12) xchg_spi(0xFF);	/* 跳过一个填充字节 */
+	n = 10;
+	do {
+		res = xchg_spi(0xFF);
+	} while ((res & 0x80) && --n);
+	return res;
 }
 
 
 
 /*-----------------------------------------------------------------------*/
-/* Inidialize a Drive                                                    */
+/* Get Drive Status                                                      */
 /*-----------------------------------------------------------------------*/
 
-DSTATUS disk_initialize (
-	BYTE pdrv				/* Physical drive nmuber to identify the drive */
+DSTATUS disk_status (
+	BYTE pdrv		/* Physical drive nmuber to identify the drive */
 )
 {
-	DSTATUS stat;
-	int result;
-
-	switch (pdrv) {
-	case DEV_RAM :
-		result = RAM_disk_initialize();
-
-		// translate the reslut code here
-
-		return stat;
-
-	case DEV_MMC :
-		result = MMC_disk_initialize();
-
-		// translate the reslut code here
+	if (pdrv) return STA_NOINIT;
+	return Stat;
+}
 
-		return stat;
 
-	case DEV_USB :
-		result = USB_disk_initialize();
 
-		// translate the reslut code here
+/*-----------------------------------------------------------------------*/
+/* Inidialize a Drive                                                    */
+/*-----------------------------------------------------------------------*/
 
-		return stat;
+DSTATUS disk_initialize (
+	BYTE pdrv				/* Physical drive nmuber to identify the drive */
+)
+{
+	BYTE n, cmd, ty, ocr[4];
+	uint64_t until;
+
+	if (pdrv) return STA_NOINIT;
+
+	spi_init(SD_SPI, SD_INIT_HZ);
+	gpio_set_function(SD_SCK_PIN, GPIO_FUNC_SPI);
+	gpio_set_function(SD_MOSI_PIN, GPIO_FUNC_SPI);
+	gpio_set_function(SD_MISO_PIN, GPIO_FUNC_SPI);
+	gpio_pull_up(SD_MISO_PIN);
+	gpio_init(SD_CS_PIN);
+	gpio_set_dir(SD_CS_PIN, GPIO_OUT);
+	gpio_put(SD_CS_PIN, 1);
+	for (n = 10; n; n--) xchg_spi(0xFF);	/* CS 高电平下至少74个时钟 */
+
+	ty = 0;
+	if (send_cmd(CMD0, 0) == 1) {
+		until = time_us_64() + 1000000;		/* 初始化最多1秒 */
+		if (send_cmd(CMD8, 0x1AA) == 1) {
+			/* SDv2：检查电压范围后以 HCS 位请求初始化 */
+			for (n = 0; n < 4; n++) ocr[n] = xchg_spi(0xFF);
+			if (ocr[2] == 0x01 && ocr[3] == 0xAA) {
+				while (time_us_64() < until && send_cmd(ACMD41, 1UL << 30)) ;
+				if (time_us_64() < until && send_cmd(CMD58, 0) == 0) {
+					for (n = 0; n < 4; n++) ocr[n] = xchg_spi(0xFF);
+					ty = (ocr[0] & 0x40) ? CT_SD2 | CT_BLOCK : CT_SD2;
+				}
+			}
+		} else {
+			/* SDv1 或 MMC */
+			if (send_cmd(ACMD41, 0) <= 1) {
+				ty = CT_SD1; cmd = ACMD41;
+			} else {
+				ty = CT_MMC; cmd = CMD1;
+			}
+			while (time_us_64() < until && send_cmd(cmd, 0)) ;
+			if (time_us_64() >= until || send_cmd(CMD16, 512) != 0) ty = 0;
+		}
+	}
+	CardType = ty;
+	sd_deselect();
+
+	if (ty) {
+		spi_set_baudrate(SD_SPI, SD_FAST_HZ);
+		Stat &= ~STA_NOINIT;
+	} else {
+		Stat = STA_NOINIT;
 	}
-	return STA_NOINIT;
+	return Stat;
 }
 
 
@@ -103,39 +249,23 @@ DRESULT disk_read (
 	UINT count		/* Number of sectors to read */
 )
 {
-	DRESULT res;
-	int result;
-
-	switch (pdrv) {
-	case DEV_RAM :
-		// translate the arguments here
-
-		result = RAM_disk_read(buff, sector, count);
-
-		// translate the reslut code here
-
-		return res;
-
-	case DEV_MMC :
-		// translate the arguments here
-
-		result = MMC_disk_read(buff, sector, count);
-
-		// translate the reslut code here
-
-		return res;
-
-	case DEV_USB :
-		// translate the arguments here
-
-		result = USB_disk_read(buff, sector, count);
-
-		// translate the reslut code here
-
-		return res;
+	if (pdrv || !count) return RES_PARERR;
+	if (Stat & STA_NOINIT) return RES_NOTRDY;
+	if (!(CardType & CT_BLOCK)) sector *= 512;	/* 字节寻址的卡 */
+
+	if (count == 1) {
+		if (send_cmd(CMD17, sector) == 0 && rcvr_datablock(buff, 512)) count = 0;
+	} else {
+		if (send_cmd(CMD18, sector) == 0) {
+			do {
+				if (!rcvr_datablock(buff, 512)) break;
+				buff += 512;
+			} while (--count);
+			send_cmd(CMD12, 0);
+		}
 	}
-
-	return RES_PARERR;
+	sd_deselect();
+	return count ? RES_ERROR : RES_OK;
 }
 
 
@@ -153,39 +283,24 @@ DRESULT disk_write (
 	UINT count			/* Number of sectors to write */
 )
 {
-	DRESULT res;
-	int result;
-
-	switch (pdrv) {
-	case DEV_RAM :
-		// translate the arguments here
-
-		result = RAM_disk_write(buff, sector, count);
-
-		// translate the reslut code here
-
-		return res;
-
-	case DEV_MMC :
-		// translate the arguments here
-
-		result = MMC_disk_write(buff, sector, count);
-
-		// translate the reslut code here
-
-		return res;
-
-	case DEV_USB :
-		// translate the arguments here
-
-		result = USB_disk_write(buff, sector, count);
-
-		// translate the reslut code here
-
-		return res;
+	if (pdrv || !count) return RES_PARERR;
+	if (Stat & STA_NOINIT) return RES_NOTRDY;
+	if (!(CardType & CT_BLOCK)) sector *= 512;
+
+	if (count == 1) {
+		if (send_cmd(CMD24, sector) == 0 && xmit_datablock(buff, 0xFE)) count = 0;
+	} else {
+		if (CardType & (CT_SD1 | CT_SD2)) send_cmd(ACMD23, count);	/* 预擦除提示 */
+		if (send_cmd(CMD25, sector) == 0) {
+			do {
+				if (!xmit_datablock(buff, 0xFC)) break;
+				buff += 512;
+			} while (--count);
+			if (!xmit_datablock(0, 0xFD)) count = 1;
+		}
 	}
-
-	return RES_PARERR;
+	sd_deselect();
+	return count ? RES_ERROR : RES_OK;
 }
 
 #endif
@@ -202,28 +317,40 @@ DRESULT disk_ioctl (
 )
 {
 	DRESULT res;
-	int result;
-
-	switch (pdrv) {
-	case DEV_RAM :
-
-		// Process of the command for the RAM drive
-
-		return res;
-
-	case DEV_MMC :
-
-		// Process of the command for the MMC/SD card
-
-		return res;
-
-	case DEV_USB :
-
-		// Process of the command the USB drive
-
-		return res;
+	BYTE n, csd[16];
+	LBA_t csize;
+
+	if (pdrv) return RES_PARERR;
+	if (Stat & STA_NOINIT) return RES_NOTRDY;
+
+	res = RES_ERROR;
+	switch (cmd) {
+	case CTRL_SYNC :		/* 等待卡完成内部写入 */
+		if (sd_select()) res = RES_OK;
+		break;
+
+	case GET_SECTOR_COUNT :	/* 由 CSD 计算扇区数 */
+		if (send_cmd(CMD9, 0) == 0 && rcvr_datablock(csd, 16)) {
+			if ((csd[0] >> 6) == 1) {	/* CSD 2.0 */
+				csize = csd[9] + ((WORD)csd[8] << 8) + ((DWORD)(csd[7] & 63) << 16) + 1;
+				*(LBA_t*)buff = csize << 10;
+			} else {					/* CSD 1.0 与 MMC */
+				n = (csd[5] & 15) + ((csd[10] & 128) >> 7) + ((csd[9] & 3) << 1) + 2;
+				csize = (csd[8] >> 6) + ((WORD)csd[7] << 2) + ((WORD)(csd[6] & 3) << 10) + 1;
+				*(LBA_t*)buff = csize << (n - 9);
+			}
+			res = RES_OK;
+		}
+		break;
+
+	case GET_BLOCK_SIZE :	/* 擦除块大小未知时按1个扇区 */
+		*(DWORD*)buff = 1;
+		res = RES_OK;
+		break;
+
+	default:
+		res = RES_PARERR;
 	}
-
-	return RES_PARERR;
+	sd_deselect();
+	return res;
 }
-
@@ -0,0 +1,197 @@
+#include "AudioDsp.h"
+#include <math.h>
+#include <stdint.h>
+#include "PackedMath.h"
+
+// 各档衰减对应的 Q16 增益，65536 为 0dB，每档乘以 10^(-0.5/20)
+struct GainTable {
+    uint32_t q16[AudioDsp::MUTE + 1];
+};
+
+static constexpr GainTable makeGainTable() {
+    GainTable table{};
+    double gain = 65536.0;
+    for (uint16_t i = 0; i < AudioDsp::MUTE; i++) {
+        table.q16[i] = static_cast<uint32_t>(gain + 0.5);
+        gain *= 0.94406087628592338;
+    }
+    table.q16[AudioDsp::MUTE] = 0;
+    return table;
+}
+
+static constexpr GainTable GAINS = makeGainTable();
+
+// 限幅级：补回各段预先衰减的增益后，超过 KNEE（约-2.5dBFS）的部分按双曲线压缩，渐近于满幅
+static constexpr int32_t KNEE = 24576;
+static constexpr int32_t RANGE = 32767 - KNEE;
+
+static inline int32_t softLimit(const int32_t value) {
+    const int32_t magnitude = value < 0 ? -value : value;
+    if (magnitude <= KNEE) {
+        return value;
+    }
+    const int32_t excess = magnitude - KNEE;
+    const int32_t limited = KNEE + excess * RANGE / (excess + RANGE);
+    return value < 0 ? -limited : limited;
+}
+
+void AudioDsp::setSampleRate(const uint32_t rate) {
+    if (rate == sampleRate || rate == 0) {
+        return;
+    }
+    sampleRate = rate;
+    rebuild();
+}
+
+bool AudioDsp::setBand(const uint8_t index, const EqBand& band) {
+    if (index >= MAX_BANDS) {
+        return false;
+    }
+    EqBand clamped = band;
+    float& gain = clamped.gainDb;
+    gain = gain > MAX_BAND_GAIN_DB ? MAX_BAND_GAIN_DB : gain < -MAX_BAND_GAIN_DB ? -MAX_BAND_GAIN_DB : gain;
+    float boost = clamped.enabled && gain > 0.0f ? gain : 0.0f;
+    for (uint8_t i = 0; i < MAX_BANDS; i++) {
+        if (i != index && bands[i].enabled && bands[i].gainDb > 0.0f) {
+            boost += bands[i].gainDb;
+        }
+    }
+    if (boost > MAX_TOTAL_BOOST_DB) {
+        return false;
+    }
+    bands[index] = clamped;
+    rebuild();
+    return true;
+}
+
+// RBJ Audio EQ Cookbook 公式，按 a0 归一化；增益为0的段等于直通，不占用级数
+void AudioDsp::rebuild() {
+    stageCount = 0;
+    float boost = 0.0f;
+    for (const EqBand& band : bands) {
+        if (!band.enabled || band.gainDb == 0.0f || band.q <= 0.0f) {
+            continue;
+        }
+        const float nyquistGuard = 0.45f * static_cast<float>(sampleRate);
+        const float frequency = band.frequencyHz < nyquistGuard ? band.frequencyHz : nyquistGuard;
+        const float a = powf(10.0f, band.gainDb / 40.0f);
+        const float w0 = 2.0f * static_cast<float>(M_PI) * frequency / static_cast<float>(sampleRate);
+        const float cosine = cosf(w0);
+        const float alpha = sinf(w0) / (2.0f * band.q);
+        const float root = 2.0f * sqrtf(a) * alpha;
+        float b[3]{};
+        float den[3]{1.0f, 0.0f, 0.0f};
+        switch (band.type) {
+            case FilterType::PEAKING:
+                b[0] = 1.0f + alpha * a;
+                b[1] = -2.0f * cosine;
+                b[2] = 1.0f - alpha * a;
+                den[0] = 1.0f + alpha / a;
+                den[1] = -2.0f * cosine;
+                den[2] = 1.0f - alpha / a;
+                break;
+            case FilterType::LOW_SHELF:
+                b[0] = a * ((a + 1.0f) - (a - 1.0f) * cosine + root);
+                b[1] = 2.0f * a * ((a - 1.0f) - (a + 1.0f) * cosine);
+                b[2] = a * ((a + 1.0f) - (a - 1.0f) * cosine - root);
+                den[0] = (a + 1.0f) + (a - 1.0f) * cosine + root;
+                den[1] = -2.0f * ((a - 1.0f) + (a + 1.0f) * cosine);
+                den[2] = (a + 1.0f) + (a - 1.0f) * cosine - root;
+                break;
+            case FilterType::HIGH_SHELF:
+                b[0] = a * ((a + 1.0f) + (a - 1.0f) * cosine + root);
+                b[1] = -2.0f * a * ((a - 1.0f) + (a + 1.0f) * cosine);
+                b[2] = a * ((a + 1.0f) + (a - 1.0f) * cosine - root);
+                den[0] = (a + 1.0f) - (a - 1.0f) * cosine + root;
+                den[1] = 2.0f * ((a - 1.0f) - (a + 1.0f) * cosine);
+                den[2] = (a + 1.0f) - (a - 1.0f) * cosine - root;
+                break;
+        }
+        // 提升的段按峰值增益 a^2 预先衰减，由限幅级补回
+        const float headroom = band.gainDb > 0.0f ? 1.0f / (a * a) : 1.0f;
+        if (band.gainDb > 0.0f) {
+            boost += band.gainDb;
+        }
+        // 系数用双精度换算，低频段的 b0 + b1 + b2 与 1 + a1 + a2 都只有1e-4量级
+        const double scale = static_cast<double>(1 << COEFF_FRAC) / den[0];
+        int32_t q[3];
+        for (uint8_t i = 0; i < 3; i++) {
+            q[i] = static_cast<int32_t>(llround(b[i] * headroom * scale));
+        }
+        Biquad& stage = stages[stageCount++];
+        stage = Biquad{};
+        stage.b0 = q[0];
+        // 低半部按有符号16位取，高半部补偿其符号
+        const int16_t low1 = static_cast<int16_t>(q[1]);
+        const int16_t low2 = static_cast<int16_t>(q[2]);
+        stage.bHigh = pack((q[2] - low2) >> 16, (q[1] - low1) >> 16);
+        stage.bLow = pack(low2, low1);
+        stage.a1 = static_cast<int32_t>(llround(-den[1] * scale));
+        stage.a2 = static_cast<int32_t>(llround(-den[2] * scale));
+    }
+    makeup = boost > 0.0f ? static_cast<int32_t>(lroundf(65536.0f * powf(10.0f, boost / 20.0f))) : 0;
+}
+
+// 一个声道的一个样本：x 项为 Q28，左移 Y_FRAC 位与 Q(28 + Y_FRAC) 的反馈项对齐后相加，y 状态按满幅饱和
+inline int32_t AudioDsp::step(Biquad& stage, const uint32_t x, const int32_t input, const uint8_t channel) {
+    int32_t& y1 = stage.y1[channel];
+    int32_t& y2 = stage.y2[channel];
+    const int64_t feedforward =
+        smlald(stage.bLow, x, smlald(stage.bHigh, x, 0) * 65536 + static_cast<int64_t>(stage.b0) * input);
+    const int64_t accumulator = feedforward * (1 << Y_FRAC) + static_cast<int64_t>(stage.a1) * y1 +
+                                static_cast<int64_t>(stage.a2) * y2;
+    int64_t y = (accumulator + (1LL << (COEFF_FRAC - 1))) >> COEFF_FRAC;
+    y = y > INT32_MAX ? INT32_MAX : y < INT32_MIN ? INT32_MIN : y;
+    y2 = y1;
+    y1 = static_cast<int32_t>(y);
+    return ssat16((y + (1 << (Y_FRAC - 1))) >> Y_FRAC);
+}
+
+void AudioDsp::applyEqualizer(uint32_t* period, const uint16_t frames) {
+    for (uint8_t s = 0; s < stageCount; s++) {
+        Biquad& stage = stages[s];
+        uint32_t xl = stage.x[0];
+        uint32_t xr = stage.x[1];
+        for (uint16_t i = 0; i < frames; i++) {
+            const uint32_t word = period[i];
+            const int32_t l = static_cast<int32_t>(word) >> 16;
+            const int32_t r = static_cast<int16_t>(word);
+            const int32_t outL = step(stage, xl, l, 0);
+            const int32_t outR = step(stage, xr, r, 1);
+            xl = xl << 16 | static_cast<uint16_t>(l);
+            xr = xr << 16 | static_cast<uint16_t>(r);
+            period[i] = pack(outL, outR);
+        }
+        stage.x[0] = xl;
+        stage.x[1] = xr;
+    }
+}
+
+// 补回增益后两个声道都不超过 KNEE 时 softLimit 直接返回，只多一次乘法
+void AudioDsp::applyLimiter(uint32_t* period, const uint16_t frames) {
+    if (makeup == 0) {
+        return;
+    }
+    for (uint16_t i = 0; i < frames; i++) {
+        const uint32_t word = period[i];
+        period[i] = pack(softLimit(smulwt(makeup, word)), softLimit(smulwb(makeup, word)));
+    }
+}
+
+void AudioDsp::applyVolume(uint32_t* period, const uint16_t frames) {
+    const uint8_t wanted = target.load(std::memory_order_relaxed);
+    const uint8_t next = current < wanted ? current + 1 : current > wanted ? current - 1 : current;
+    const int32_t from = static_cast<int32_t>(GAINS.q16[current]);
+    const int32_t to = static_cast<int32_t>(GAINS.q16[next]);
+    current = next;
+    if (from == to && to == 65536) {
+        return;
+    }
+    const int32_t step = frames ? (to - from) / frames : 0;
+    int32_t gain = from;
+    for (uint16_t i = 0; i < frames; i++) {
+        const uint32_t word = period[i];
+        period[i] = pack(smulwt(gain, word), smulwb(gain, word));
+        gain += step;
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef AUDIO_DSP_H
+#define AUDIO_DSP_H
+#include <stdint.h>
+#include <atomic>
+
+enum class FilterType : uint8_t {
+    PEAKING, LOW_SHELF, HIGH_SHELF
+};
+
+// 一段参数均衡，增益限制在 ±MAX_BAND_GAIN_DB
+struct EqBand {
+    bool enabled = false;
+    FilterType type = FilterType::PEAKING;
+    float frequencyHz = 1000.0f;
+    float gainDb = 0.0f;
+    float q = 0.707f;
+};
+
+// 按整个 PCM 周期处理的音效：参数均衡 -> 软限幅 -> 音量，就地修改环中的打包立体声（L<<16 | R）。
+// 提升的段按各自的峰值增益预先衰减，级间信号不会超过满幅；限幅级补回全部提升并把超出满幅的部分柔和地压回。
+// 各段提升之和不超过 MAX_TOTAL_BOOST_DB，否则16位的级间信号损失的精度过多；没有提升的段时限幅级跳过。音量按0.5dB一档，每个周期最多移动一档并在周期内线性插值，避免拉链噪声。
+// Cortex-M33 上均衡用 SMLALD（SMLAD 的64位累加形式）和 SSAT，限幅与音量用 SMULWT/SMULWB 取出打包的两个声道相乘，
+// 限幅级再按 softLimit 的曲线压回满幅；其他平台用等价的 C++ 实现
+class AudioDsp {
+public:
+    static constexpr uint8_t MAX_BANDS = 8;
+    static constexpr float MAX_BAND_GAIN_DB = 12.0f;
+    static constexpr float MAX_TOTAL_BOOST_DB = 12.0f;
+    // 衰减档位，每档0.5dB，0 为原音量，MUTE 为静音
+    static constexpr uint8_t MUTE = 128;
+
+    // 采样率变化时重算滤波器系数并清空滤波器状态
+    void setSampleRate(uint32_t rate);
+
+    // 只能在处理周期的任务中调用；启用后各段提升之和超过 MAX_TOTAL_BOOST_DB 时不生效并返回 false
+    bool setBand(uint8_t index, const EqBand& band);
+
+    [[nodiscard]] const EqBand& getBand(const uint8_t index) const {
+        return bands[index];
+    }
+
+    // 可在任意任务中调用，从下一个周期开始逐档过渡
+    void setAttenuation(const uint8_t halfDb) {
+        target.store(halfDb < MUTE ? halfDb : MUTE, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint8_t getAttenuation() const {
+        return target.load(std::memory_order_relaxed);
+    }
+
+    void process(uint32_t* period, const uint16_t frames) {
+        applyEqualizer(period, frames);
+        applyLimiter(period, frames);
+        applyVolume(period, frames);
+    }
+
+    // 各级单独公开，便于分别计时
+    void applyEqualizer(uint32_t* period, uint16_t frames);
+    void applyLimiter(uint32_t* period, uint16_t frames);
+    void applyVolume(uint32_t* period, uint16_t frames);
+
+private:
+    // 系数与 y 状态的小数位数
+    static constexpr uint8_t COEFF_FRAC = 28;
+    static constexpr uint8_t Y_FRAC = 16;
+
+    // 直接I型双二阶节，系数均为 Q28。x 状态按声道打包为 (n-2)<<16 | (n-1)，b1、b2 拆成高低两个16位半部，
+    // 与 bHigh = b2h<<16 | b1h、bLow = b2l<<16 | b1l 各做一次 SMLALD；y 状态为带16位小数的32位值（饱和在满幅）。
+    // 低频段的 1 - cos(w0) 只有1e-4量级：16位系数会让响应偏差数dB，只保留16位输出历史会留下直流残留和极限环
+    struct Biquad {
+        int32_t b0 = 0;
+        uint32_t bHigh = 0;
+        uint32_t bLow = 0;
+        int32_t a1 = 0; // -a1/a0
+        int32_t a2 = 0; // -a2/a0
+        uint32_t x[2]{};
+        int32_t y1[2]{};
+        int32_t y2[2]{};
+    };
+
+    EqBand bands[MAX_BANDS]{};
+    Biquad stages[MAX_BANDS]{};
+    uint8_t stageCount = 0;
+    int32_t makeup = 0; // 限幅级补回的增益（Q16），0 表示没有提升、跳过限幅级
+    uint32_t sampleRate = 44100;
+    std::atomic<uint8_t> target{0};
+    uint8_t current = 0;
+
+    void rebuild();
+    static int32_t step(Biquad& stage, uint32_t x, int32_t input, uint8_t channel);
+};
+
+#endif // AUDIO_DSP_H
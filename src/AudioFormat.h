@@ -0,0 +1,22 @@
+#ifndef AUDIO_FORMAT_H
+#define AUDIO_FORMAT_H
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+enum class AudioFormat : uint8_t {
+    MP3, FLAC, VORBIS
+};
+
+// 按扩展名选择解码器，.flac 和 .ogg 以外的文件都按 MP3 处理
+inline AudioFormat formatOf(const char* path) {
+    const auto hasExtension = [path](const char* extension) {
+        const size_t length = strlen(path);
+        const size_t extensionLength = strlen(extension);
+        return length > extensionLength && strcasecmp(path + length - extensionLength, extension) == 0;
+    };
+    // FatFs 未启用长文件名，卡上的 .flac 以 8.3 短名 .FLA 出现
+    return hasExtension(".flac") || hasExtension(".fla") ? AudioFormat::FLAC : hasExtension(".ogg") ? AudioFormat::VORBIS : AudioFormat::MP3;
+}
+
+#endif // AUDIO_FORMAT_H
@@ -0,0 +1,366 @@
+#include "AudioPipeline.h"
+#include <string.h>
+#include "VorbisArena.h"
+#include "hardware/clocks.h"
+
+// minimp3 的 mp3dec_decode_frame() 在栈上使用约16KB的临时空间，Tremor 用 alloca 取的逐块临时空间更少
+static constexpr uint32_t DECODE_STACK_WORDS = 6144;
+
+bool AudioPipeline::begin(const UBaseType_t priority) {
+    requests = xQueueCreate(REQUEST_QUEUE_SIZE, sizeof(Request));
+    if (requests == nullptr) {
+        return false;
+    }
+    return xTaskCreateAffinitySet(decodeTask, "DECODE", DECODE_STACK_WORDS, this, priority, 1 << DECODE_CORE,
+                                  &task) == pdPASS;
+}
+
+bool AudioPipeline::play(const char* path) {
+    Request request{RequestType::OPEN, {}};
+    strncpy(request.path, path, PATH_LENGTH - 1);
+    request.requestedAt = time_us_64();
+    return xQueueSend(requests, &request, 0) == pdPASS;
+}
+
+bool AudioPipeline::stop() {
+    const Request request{RequestType::CLOSE, {}};
+    return xQueueSend(requests, &request, 0) == pdPASS;
+}
+
+bool AudioPipeline::seek(const uint32_t positionMs) {
+    Request request{RequestType::SEEK, {}};
+    request.positionMs = positionMs;
+    request.requestedAt = time_us_64();
+    return xQueueSend(requests, &request, 0) == pdPASS;
+}
+
+// 滤波器系数与状态只在解码任务中修改，避免与正在处理的周期竞争
+bool AudioPipeline::setEqualizer(const uint8_t index, const EqBand& band) {
+    const Request request{RequestType::EQUALIZER, {}, index, band};
+    return xQueueSend(requests, &request, 0) == pdPASS;
+}
+
+bool AudioPipeline::setNeighbours(const char* next, const char* previous) {
+    const char* paths[StartCache::SLOTS] = {next, previous};
+    for (uint8_t slot = 0; slot < StartCache::SLOTS; slot++) {
+        Request request{RequestType::PREFETCH, {}, slot};
+        strncpy(request.path, paths[slot] ? paths[slot] : "", PATH_LENGTH - 1);
+        if (xQueueSend(requests, &request, 0) != pdPASS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+AudioStats AudioPipeline::snapshot() const {
+    AudioStats copy = stats;
+    copy.underruns = ring.getUnderruns();
+    copy.overruns = ring.getOverruns();
+    copy.arenaPeak = VorbisArena::getPeak();
+    copy.clockMhz = static_cast<uint16_t>(clock_get_hz(clk_sys) / 1000000);
+    uint8_t history[AudioRing::HISTORY_SIZE];
+    const uint8_t count = ring.watermarkHistory(history);
+    copy.lowWater = count ? AudioRing::PERIOD_COUNT : 0;
+    for (uint8_t i = 0; i < count; i++) {
+        copy.lowWater = history[i] < copy.lowWater ? history[i] : copy.lowWater;
+    }
+    return copy;
+}
+
+void AudioPipeline::decodeTask(void* arg) {
+    static_cast<AudioPipeline*>(arg)->run();
+}
+
+void AudioPipeline::notifyFromIsr(void* arg) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(static_cast<TaskHandle_t>(arg), &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// 正在播放时切歌或停止，丢弃环中上一首尚未播出的部分
+void AudioPipeline::handle(const Request& request) {
+    if (request.type == RequestType::EQUALIZER) {
+        dsp.setBand(request.index, request.eq);
+        return;
+    }
+    if (request.type == RequestType::PREFETCH) {
+        // 下一首换了：已预先打开的旧的下一首作废（它用到的缓存可能随即被改写）
+        if (request.index == 0 && strncmp(nextPath, request.path, PATH_LENGTH) != 0) {
+            closeUpcoming();
+        }
+        cache.assign(request.index, request.path);
+        if (request.index == 0) {
+            memcpy(nextPath, request.path, PATH_LENGTH);
+        }
+        return;
+    }
+    if (request.type == RequestType::SEEK) {
+        if (playing) {
+            seekTo(request);
+        }
+        return;
+    }
+    const bool skipping = playing;
+    endTrack();
+    if (skipping) {
+        ring.discard();
+    }
+    if (request.type != RequestType::OPEN) {
+        return;
+    }
+    soundPendingSince = request.requestedAt;
+    StartCache::Entry* entry = cache.find(request.path);
+    if (entry) {
+        stats.cacheHits++;
+        startFromCache(*entry);
+        cache.consume(entry);
+        return;
+    }
+    stats.cacheMisses++;
+    if (!open(request.path)) {
+        soundPendingSince = 0;
+    }
+}
+
+bool AudioPipeline::open(const char* path) {
+    if (!track->open(path) || !track->activate()) {
+        track->close();
+        return false;
+    }
+    playing = true;
+    return true;
+}
+
+// 先把缓存写入环（第一个周期写满即开始发声），写入其余部分时环中已有约105ms的余量，
+// 足够重新打开文件并把解码器恢复到缓存末尾
+bool AudioPipeline::startFromCache(StartCache::Entry& entry) {
+    applySampleRate(entry.sampleRate);
+    ring.setStreaming(true);
+    writePcm(entry.pcm, entry.frames, 2);
+    if (!track->resume(entry) || !track->activate()) {
+        endTrack();
+        return false;
+    }
+    playing = true;
+    return true;
+}
+
+// 丢弃环中旧位置尚未播出的数据后从新位置解码；MP3 不支持定位（自由比特率等）时忽略请求，
+// 其余定位失败（超出末尾、读错误）时结束当前曲目
+void AudioPipeline::seekTo(const Request& request) {
+    if (!track->isSeekable()) {
+        return;
+    }
+    drainRing();
+    ring.discard();
+    resampler.reset();
+    seekPendingSince = request.requestedAt;
+    if (!track->seek(request.positionMs)) {
+        seekPendingSince = 0;
+        endTrack();
+    }
+}
+
+// 预解码没有工作时，借 StartCache 的读取器在后台扫完当前 MP3 的帧头，之后任意位置的定位都只查表，
+// 不必在请求时线性扫描；扫完后索引随即保存
+bool AudioPipeline::indexStep() {
+    FileReader* idle = cache.idleReader();
+    return idle && track->extendIndex(*idle, INDEX_STEP_FRAMES);
+}
+
+// 连续播放时，当前曲目剩余不到环的深度就在环满的空闲时间里打开下一首：启动缓存已解好时恢复到缓存末尾，
+// 否则从头打开。到了末尾 continueWithNext() 只需交换两首，不在环中余量最少的时刻读卡、解析文件头。
+// 打开失败时不再重试，播完当前曲目即停止
+bool AudioPipeline::prepareNext() {
+    if (!continuous.load(std::memory_order_relaxed) || nextPath[0] == '\0' || upcoming->isOpen() ||
+        track->remainingMs() > RING_DEPTH_MS) {
+        return false;
+    }
+    StartCache::Entry* entry = cache.find(nextPath);
+    const bool prepared = entry ? upcoming->resume(*entry) : upcoming->open(nextPath);
+    if (!prepared) {
+        upcoming->close();
+        nextPath[0] = '\0';
+        return true;
+    }
+    upcomingEntry = entry;
+    return true;
+}
+
+// 当前曲目播完时接上下一首：不补齐周期、不重置采样率转换历史，下一首的第一个样本紧接着上一首的最后一个样本。
+// 下一首通常已由 prepareNext() 打开，没来得及时（曲目极短或环一直不满）在此打开。下一首只接一次，需由界面重新设置相邻曲目
+bool AudioPipeline::continueWithNext() {
+    if (!continuous.load(std::memory_order_relaxed) || nextPath[0] == '\0') {
+        return false;
+    }
+    // 当前曲目关闭后剩余时长为0，没来得及预先打开的下一首此时一定会尝试打开
+    closeTrack();
+    prepareNext();
+    if (!upcoming->isOpen()) {
+        return false;
+    }
+    nextPath[0] = '\0';
+    TrackSlot* finished = track;
+    track = upcoming;
+    upcoming = finished;
+    trackChanges.fetch_add(1, std::memory_order_relaxed);
+    if (upcomingEntry) {
+        stats.cacheHits++;
+        applySampleRate(upcomingEntry->sampleRate);
+        writePcm(upcomingEntry->pcm, upcomingEntry->frames, 2);
+        cache.consume(upcomingEntry);
+        upcomingEntry = nullptr;
+    } else {
+        stats.cacheMisses++;
+    }
+    return track->activate();
+}
+
+void AudioPipeline::closeUpcoming() {
+    upcoming->close();
+    upcomingEntry = nullptr;
+}
+
+void AudioPipeline::closeTrack() {
+    track->close();
+    // 后台索引借用的读取器还开着本曲目
+    if (FileReader* idle = cache.idleReader()) {
+        idle->close();
+    }
+}
+
+void AudioPipeline::endTrack() {
+    closeTrack();
+    closeUpcoming();
+    resampler.reset();
+    playing = false;
+    drainRing();
+}
+
+// 用静音补齐最后一个不满的周期并停止欠载计数，之后 DMA 播完环中剩余数据转为静音属于正常空闲
+void AudioPipeline::drainRing() {
+    while (!ring.flush()) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+    }
+    ring.setStreaming(false);
+}
+
+// 支持的采样率转换到固定的输出时钟，不必重设 PIO 分频；其余采样率等上一首（旧采样率）
+// 已写入的数据播完再切换位时钟
+void AudioPipeline::applySampleRate(const uint32_t rate) {
+    if (rate == inputRate) {
+        return;
+    }
+    inputRate = rate;
+    const uint32_t outputRate = resampler.configure(rate) ? Resampler::OUTPUT_RATE : rate;
+    dsp.setSampleRate(outputRate);
+    if (outputRate == output.getSampleRate()) {
+        return;
+    }
+    while (ring.readyPeriods() > 0) {
+        vTaskDelay(1);
+    }
+    output.setSampleRate(outputRate);
+}
+
+void AudioPipeline::writePcm(const int16_t* samples, const uint32_t frames, const uint8_t channels) {
+    if (resampler.isActive()) {
+        resampler.process(samples, frames, channels, writeResampled, this);
+    } else {
+        writeRing(samples, frames, channels);
+    }
+}
+
+void AudioPipeline::writeRing(const int16_t* samples, const uint32_t frames, const uint8_t channels) {
+    uint32_t written = 0;
+    while (written < frames) {
+        written += ring.write(samples + written * channels, frames - written, channels);
+        if (written < frames) {
+            const uint64_t waitFrom = time_us_64();
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+            blockedUs += time_us_64() - waitFrom;
+        }
+    }
+}
+
+// 解码器的输出：按当前曲目的采样率（串联的 Ogg 文件可能在流之间改变）选择转换后写入环
+void AudioPipeline::writeDecoded(const int16_t* samples, const uint32_t frames, const uint8_t channels, void* arg) {
+    auto* self = static_cast<AudioPipeline*>(arg);
+    self->applySampleRate(self->track->getSampleRate());
+    self->writePcm(samples, frames, channels);
+}
+
+void AudioPipeline::writeResampled(const int16_t* samples, const uint32_t frames, void* arg) {
+    static_cast<AudioPipeline*>(arg)->writeRing(samples, frames, 2);
+}
+
+// 各级分别计时；这段时间计入所在帧的解码耗时
+void AudioPipeline::processPeriod(uint32_t* period, const uint16_t frames, void* arg) {
+    auto* self = static_cast<AudioPipeline*>(arg);
+    uint64_t at = time_us_64();
+    self->dsp.applyEqualizer(period, frames);
+    uint64_t now = time_us_64();
+    self->stats.dspUs[0] += now - at;
+    at = now;
+    self->dsp.applyLimiter(period, frames);
+    now = time_us_64();
+    self->stats.dspUs[1] += now - at;
+    at = now;
+    self->dsp.applyVolume(period, frames);
+    self->stats.dspUs[2] += time_us_64() - at;
+    self->stats.dspFrames += frames;
+    if (self->soundPendingSince) {
+        self->stats.skipLatency.record(time_us_64() - self->soundPendingSince);
+        self->soundPendingSince = 0;
+    }
+    if (self->seekPendingSince) {
+        self->stats.seekLatency.record(time_us_64() - self->seekPendingSince);
+        self->seekPendingSince = 0;
+    }
+}
+
+// 解出一帧写入PCM环，返回 false 表示文件结束
+bool AudioPipeline::decodeFrame() {
+    const uint64_t startedAt = time_us_64();
+    blockedUs = 0;
+    const uint32_t samples = track->decode();
+    if (samples == 0) {
+        return false;
+    }
+    ring.setStreaming(true);
+    stats.decodeUs.record(time_us_64() - startedAt - blockedUs);
+    stats.frames++;
+    stats.audioUs += samples * 1000000ull / inputRate;
+    stats.sampleRate = inputRate;
+    stats.bitrateKbps = track->getBitrateKbps();
+    return true;
+}
+
+void AudioPipeline::run() {
+    output.setNotify(notifyFromIsr, xTaskGetCurrentTaskHandle());
+    output.begin(ring, Resampler::OUTPUT_RATE);
+    dsp.setSampleRate(Resampler::OUTPUT_RATE);
+    ring.setPeriodHook(processPeriod, this);
+    Request request{};
+    while (true) {
+        // 空闲且没有预解码工作时阻塞等待请求，否则只取不等
+        while (xQueueReceive(requests, &request, playing || cache.hasWork() ? 0 : portMAX_DELAY) == pdPASS) {
+            handle(request);
+        }
+        if (!playing) {
+            cache.step();
+            continue;
+        }
+        // 环中放不下一整帧时先用空闲时间预先打开快要衔接的下一首，再预解码相邻曲目、扫描当前曲目的索引，
+        // 都没有可做的才等待 DMA 归还周期
+        if (ring.freeFrames() < MINIMP3_MAX_SAMPLES_PER_FRAME / 2) {
+            if (!prepareNext() && !cache.step() && !indexStep()) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50));
+            }
+            continue;
+        }
+        if (!decodeFrame() && !continueWithNext()) {
+            endTrack();
+        }
+    }
+}
@@ -0,0 +1,200 @@
+#ifndef AUDIO_PIPELINE_H
+#define AUDIO_PIPELINE_H
+#include <atomic>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "VorbisDecoder.h"
+#include "AudioDsp.h"
+#include "Resampler.h"
+#include "StartCache.h"
+#include "TrackSlot.h"
+#include "I2sOutput.h"
+#include "PlayerStats.h"
+
+// 解码统计：每帧解码耗时与已解码的音频时长，load = 解码耗时 / 音频时长。
+// lowWater 为最近若干个水位窗口中 PCM 环的最低填充周期数，接近0说明解码余量不足。
+// 音效各级（均衡、限幅、音量）的累计耗时按 sys_clk 换算为每个单声道样本的周期数
+struct AudioStats {
+    static constexpr uint8_t DSP_STAGES = 3;
+    LatencyHistogram decodeUs;
+    uint64_t audioUs = 0;
+    uint32_t frames = 0;
+    uint32_t underruns = 0;
+    uint32_t overruns = 0;
+    uint32_t arenaPeak = 0; // Vorbis 解码静态区域的峰值占用（字节）
+    uint8_t lowWater = 0;
+    uint16_t sampleRate = 0;
+    uint16_t bitrateKbps = 0;
+    uint64_t dspUs[DSP_STAGES]{};
+    uint64_t dspFrames = 0;
+    uint16_t clockMhz = 0;
+    // 从请求播放到新曲目的第一个周期写入环，不含 DMA 中已排队的最多两个周期
+    LatencyHistogram skipLatency;
+    uint32_t cacheHits = 0;
+    uint32_t cacheMisses = 0;
+    // 从请求定位到新位置的第一个周期写入环
+    LatencyHistogram seekLatency;
+
+    [[nodiscard]] uint32_t loadPermille() const {
+        return audioUs ? decodeUs.totalUs * 1000 / audioUs : 0;
+    }
+
+    // 百分之一周期
+    [[nodiscard]] uint32_t dspCentiCyclesPerSample(const uint8_t stage) const {
+        return dspFrames ? dspUs[stage] * clockMhz * 100 / (dspFrames * 2) : 0;
+    }
+
+    void print() const {
+        printf("audio: %u Hz %u kbps, %lu frames, load %lu.%lu%%, frame p50<=%luus max=%luus, underruns %lu, "
+               "overruns %lu, low water %u/%u, vorbis arena peak %lu\n",
+               sampleRate, bitrateKbps, static_cast<unsigned long>(frames),
+               static_cast<unsigned long>(loadPermille() / 10), static_cast<unsigned long>(loadPermille() % 10),
+               static_cast<unsigned long>(decodeUs.percentileUs(50)), static_cast<unsigned long>(decodeUs.maxUs),
+               static_cast<unsigned long>(underruns), static_cast<unsigned long>(overruns), lowWater,
+               AudioRing::PERIOD_COUNT, static_cast<unsigned long>(arenaPeak));
+        const char* names[DSP_STAGES] = {"eq", "limiter", "volume"};
+        printf("  dsp cycles/sample:");
+        for (uint8_t i = 0; i < DSP_STAGES; i++) {
+            const uint32_t centi = dspCentiCyclesPerSample(i);
+            printf(" %s %lu.%02lu", names[i], static_cast<unsigned long>(centi / 100),
+                   static_cast<unsigned long>(centi % 100));
+        }
+        printf("\n");
+        printf("  skip: start cache %lu hit / %lu miss, latency p50<=%luus p99<=%luus max=%luus\n",
+               static_cast<unsigned long>(cacheHits), static_cast<unsigned long>(cacheMisses),
+               static_cast<unsigned long>(skipLatency.percentileUs(50)),
+               static_cast<unsigned long>(skipLatency.percentileUs(99)), static_cast<unsigned long>(skipLatency.maxUs));
+        printf("  seek: latency p50<=%luus p99<=%luus max=%luus\n",
+               static_cast<unsigned long>(seekLatency.percentileUs(50)),
+               static_cast<unsigned long>(seekLatency.percentileUs(99)), static_cast<unsigned long>(seekLatency.maxUs));
+    }
+};
+
+// 片内软件解码管线：FatFs 读取 -> minimp3/libFLAC/Tremor 逐帧解码 -> 采样率转换 -> PCM 周期环（音效）
+// -> 双 DMA 通道 -> PIO I2S。
+// 解码任务与 DMA 中断都在 core 1 上，core 0 留给界面；解码任务在环满时阻塞，DMA 归还周期后唤醒。
+//
+// 44.1kHz 立体声的 CPU 预算（sys_clk 150MHz，每个 MP3 帧1152个样本 = 26.1ms = 3.92M 周期）：
+//   minimp3 解码       <= 40%  每帧不超过约1.57M周期（约60MHz），实际值见 AudioStats 的 load 与帧耗时
+//   （Tremor 解码      <= 40%  与 minimp3 相同的预算，每段最多1024帧；另占 VorbisArena 的128KB静态区域）
+//   FatFs/SD 读取        ~2%   每8KB补一次缓冲，320kbps 时约每秒5次
+//   MP3 后台索引        空闲时  预解码没有工作时每步解析32个帧头，每首一次；60分钟 48kbps 的文件约读21MB
+//   打包写入 PCM 环      <1%   每帧1152次32位写入
+//   DMA 中断             <1%   每周期（576帧，13ms）一次，只改读地址
+//   采样率转换          <= 5%   48kHz/22.05kHz 输入时，每个输出帧32次 SMLAD x 2声道
+//   音效处理            <= 8%   8段均衡每段每样本约14周期（3次 SMLAL + 2次 SMLALD），限幅与音量各约3周期，
+//                               实际值见 dsp cycles/sample
+//   余量               >= 42%  同核的 PLAYER 任务
+class AudioPipeline {
+public:
+    static constexpr uint8_t DECODE_CORE = 1;
+    static constexpr uint16_t PATH_LENGTH = StartCache::PATH_LENGTH;
+    static constexpr uint8_t REQUEST_QUEUE_SIZE = 8;
+    // 后台索引每步解析的帧头数：128kbps 时约一次16KB的补充读取，远小于环中约100ms的余量
+    static constexpr uint16_t INDEX_STEP_FRAMES = 32;
+    // 连续播放时，当前曲目剩余不到环的深度（约104ms）就预先打开下一首
+    static constexpr uint32_t RING_DEPTH_MS =
+        static_cast<uint32_t>(AudioRing::PERIOD_FRAMES) * AudioRing::PERIOD_COUNT * 1000 / Resampler::OUTPUT_RATE;
+
+    AudioPipeline(PIO pio, const uint dataPin, const uint clockPinBase)
+        : output(pio, dataPin, clockPinBase), slots{{vorbis, writeDecoded, this}, {vorbis, writeDecoded, this}} {
+    }
+
+    // 创建绑定在 core 1 上的解码任务，I2S 输出在该任务中初始化
+    bool begin(UBaseType_t priority);
+
+    // 以下可在任意任务中调用，请求排队交给解码任务
+    bool play(const char* path);
+    bool stop();
+    // 跳到当前曲目的 positionMs 毫秒处，超出曲目末尾时结束播放
+    bool seek(uint32_t positionMs);
+    // 播放队列中与当前曲目相邻的两首，空闲时预解码其开头；切歌后应重新设置
+    bool setNeighbours(const char* next, const char* previous);
+    // 返回值只表示请求已入队；使各段提升之和超过 AudioDsp::MAX_TOTAL_BOOST_DB 的设置在解码任务中被忽略
+    bool setEqualizer(uint8_t index, const EqBand& band);
+
+    // 连续播放：当前曲目播完时不补静音，直接把 setNeighbours 的下一首接着写入环，两首按样本衔接；
+    // 下一首在当前曲目剩余不到 RING_DEPTH_MS 时预先打开，开头多半已在启动缓存中解好。可在任意任务中直接调用
+    void setContinuous(const bool enabled) {
+        continuous.store(enabled, std::memory_order_relaxed);
+    }
+
+    // 连续播放时自动接上下一首的次数；界面发现变化后应把当前曲目后移一首并重新调用 setNeighbours
+    [[nodiscard]] uint32_t getTrackChanges() const {
+        return trackChanges.load(std::memory_order_relaxed);
+    }
+
+    // 软件音量，每档0.5dB，AudioDsp::MUTE 为静音；可在任意任务中直接调用
+    void setAttenuation(const uint8_t halfDb) {
+        dsp.setAttenuation(halfDb);
+    }
+
+    [[nodiscard]] bool isPlaying() const {
+        return playing.load(std::memory_order_relaxed);
+    }
+
+    // 统计快照，各项不保证取自同一时刻
+    [[nodiscard]] AudioStats snapshot() const;
+
+private:
+    enum class RequestType : uint8_t {
+        OPEN, CLOSE, EQUALIZER, PREFETCH, SEEK
+    };
+
+    struct Request {
+        RequestType type;
+        char path[PATH_LENGTH];
+        uint8_t index = 0; // EQUALIZER 的段号或 PREFETCH 的槽位
+        EqBand eq{};
+        uint32_t positionMs = 0;
+        uint64_t requestedAt = 0;
+    };
+
+    AudioRing ring;
+    I2sOutput output;
+    VorbisDecoder vorbis;
+    // 正在播放的一首与预先打开的下一首，衔接时交换
+    TrackSlot slots[2];
+    TrackSlot* track = &slots[0];
+    TrackSlot* upcoming = &slots[1];
+    StartCache::Entry* upcomingEntry = nullptr; // 下一首从启动缓存恢复时，衔接时先写出的缓存
+    AudioDsp dsp;
+    Resampler resampler;
+    uint32_t inputRate = 0; // 解码输出的采样率
+    StartCache cache;
+    char nextPath[PATH_LENGTH]{};
+    uint64_t soundPendingSince = 0; // 等待新曲目第一个周期的请求时刻，0 表示没有
+    uint64_t seekPendingSince = 0;
+    uint64_t blockedUs = 0; // 本帧写入时等待环空出的时间，不计入解码耗时
+    QueueHandle_t requests = nullptr;
+    TaskHandle_t task = nullptr;
+    std::atomic<bool> playing{false};
+    std::atomic<bool> continuous{false};
+    std::atomic<uint32_t> trackChanges{0};
+    AudioStats stats;
+
+    void run();
+    void handle(const Request& request);
+    bool open(const char* path);
+    bool startFromCache(StartCache::Entry& entry);
+    void seekTo(const Request& request);
+    bool indexStep();
+    bool decodeFrame();
+    void applySampleRate(uint32_t rate);
+    bool prepareNext();
+    bool continueWithNext();
+    void closeUpcoming();
+    void closeTrack();
+    void endTrack();
+    void drainRing();
+    void writePcm(const int16_t* samples, uint32_t frames, uint8_t channels);
+    void writeRing(const int16_t* samples, uint32_t frames, uint8_t channels);
+    static void writeDecoded(const int16_t* samples, uint32_t frames, uint8_t channels, void* arg);
+    static void writeResampled(const int16_t* samples, uint32_t frames, void* arg);
+    static void processPeriod(uint32_t* period, uint16_t frames, void* arg);
+    static void decodeTask(void* arg);
+    static void notifyFromIsr(void* arg);
+};
+
+#endif // AUDIO_PIPELINE_H
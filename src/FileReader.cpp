@@ -0,0 +1,108 @@
+#include "FileReader.h"
+#include <string.h>
+
+bool FileReader::open(const char* path) {
+    close();
+#if PICO_ON_DEVICE
+    if (f_open(&file, path, FA_READ) != FR_OK) {
+        return false;
+    }
+    fileSize = f_size(&file);
+    // 有了簇链映射 f_lseek 不再沿 FAT 链逐簇查找，定位只读目标位置的数据；碎片太多、表放不下时退回逐簇查找
+    linkMap[0] = LINK_MAP_SIZE;
+    file.cltbl = linkMap;
+    if (f_lseek(&file, CREATE_LINKMAP) != FR_OK) {
+        file.cltbl = nullptr;
+    }
+#else
+    file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+#endif
+    opened = true;
+    return true;
+}
+
+void FileReader::close() {
+    if (opened) {
+#if PICO_ON_DEVICE
+        f_close(&file);
+#else
+        fclose(file);
+        file = nullptr;
+#endif
+    }
+    opened = false;
+    start = 0;
+    end = 0;
+    position = 0;
+    fileSize = 0;
+}
+
+size_t FileReader::refill() {
+    if (start > 0) {
+        memmove(buffer, buffer + start, end - start);
+        end -= start;
+        start = 0;
+    }
+    if (!opened || end == BUFFER_SIZE || position >= fileSize) {
+        return end;
+    }
+#if PICO_ON_DEVICE
+    UINT read = 0;
+    if (f_read(&file, buffer + end, BUFFER_SIZE - end, &read) != FR_OK) {
+        read = 0;
+        position = fileSize;
+    }
+#else
+    const size_t read = fread(buffer + end, 1, BUFFER_SIZE - end, file);
+#endif
+    end += read;
+    position += read;
+    if (read == 0) {
+        position = fileSize;
+    }
+    return end;
+}
+
+size_t FileReader::read(uint8_t* dest, const size_t length) {
+    size_t copied = available() < length ? available() : length;
+    memcpy(dest, data(), copied);
+    consume(copied);
+    if (copied == length || !opened || position >= fileSize) {
+        return copied;
+    }
+#if PICO_ON_DEVICE
+    UINT read = 0;
+    if (f_read(&file, dest + copied, length - copied, &read) != FR_OK) {
+        read = 0;
+    }
+#else
+    const size_t read = fread(dest + copied, 1, length - copied, file);
+#endif
+    position = read ? position + read : fileSize;
+    return copied + read;
+}
+
+bool FileReader::seek(const uint32_t offset) {
+    if (!opened || offset > fileSize) {
+        return false;
+    }
+#if PICO_ON_DEVICE
+    if (f_lseek(&file, offset) != FR_OK) {
+        return false;
+    }
+#else
+    if (fseek(file, offset, SEEK_SET) != 0) {
+        return false;
+    }
+#endif
+    start = 0;
+    end = 0;
+    position = offset;
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef FILE_READER_H
+#define FILE_READER_H
+#include <stdint.h>
+#include <stddef.h>
+#if PICO_ON_DEVICE
+#include "ff.h"
+#else
+#include <stdio.h>
+#endif
+
+// 带缓冲的顺序文件读取：解码器直接在缓冲区上解析，消耗后再由 refill() 从文件补齐。
+// 设备上经 FatFs 读取，主机构建时改用标准库文件，便于在 PC 上验证解码结果
+class FileReader {
+public:
+    // minimp3 建议一次提供约16KB数据以可靠同步到首帧
+    static constexpr size_t BUFFER_SIZE = 16384;
+
+    bool open(const char* path);
+    void close();
+
+    [[nodiscard]] const uint8_t* data() const {
+        return buffer + start;
+    }
+
+    [[nodiscard]] size_t available() const {
+        return end - start;
+    }
+
+    void consume(const size_t length) {
+        start += length < available() ? length : available();
+    }
+
+    // 把未消耗的数据移到缓冲区开头并从文件补满，返回可用字节数
+    size_t refill();
+
+    // 先取缓冲区中剩余的数据，其余直接从文件读入 dest，不经过缓冲区；返回读到的字节数
+    size_t read(uint8_t* dest, size_t length);
+
+    // 跳转到文件中的绝对位置，丢弃缓冲区
+    bool seek(uint32_t offset);
+
+    // 缓冲区起点在文件中的位置
+    [[nodiscard]] uint32_t tell() const {
+        return position - (end - start);
+    }
+
+    [[nodiscard]] uint32_t size() const {
+        return fileSize;
+    }
+
+    [[nodiscard]] bool isOpen() const {
+        return opened;
+    }
+
+    // 文件已读完且缓冲区已消耗完
+    [[nodiscard]] bool isEof() const {
+        return position >= fileSize && start == end;
+    }
+
+private:
+#if PICO_ON_DEVICE
+    // 快速定位的簇链映射表，最多 (LINK_MAP_SIZE - 1) / 2 个连续片段
+    static constexpr uint8_t LINK_MAP_SIZE = 32;
+    FIL file{};
+    DWORD linkMap[LINK_MAP_SIZE]{};
+#else
+    FILE* file = nullptr;
+#endif
+    uint8_t buffer[BUFFER_SIZE]{};
+    size_t start = 0;
+    size_t end = 0;
+    uint32_t position = 0; // 下一次从文件读取的位置
+    uint32_t fileSize = 0;
+    bool opened = false;
+};
+
+#endif // FILE_READER_H
@@ -0,0 +1,135 @@
+#include "FlacDecoder.h"
+
+FlacDecoder::~FlacDecoder() {
+    if (decoder) {
+        FLAC__stream_decoder_delete(decoder);
+    }
+}
+
+bool FlacDecoder::start(FileReader& reader, const Sink sink, void* arg) {
+    finish();
+    if (decoder == nullptr) {
+        decoder = FLAC__stream_decoder_new();
+        if (decoder == nullptr) {
+            return false;
+        }
+    }
+    this->reader = &reader;
+    sinkArg = arg;
+    this->sink = sink;
+    sampleRate = 0;
+    channels = 0;
+    bitsPerSample = 0;
+    totalSamples = 0;
+    if (FLAC__stream_decoder_init_stream(decoder, readCallback, seekCallback, tellCallback, lengthCallback,
+                                         eofCallback, writeCallback, metadataCallback, errorCallback, this) !=
+        FLAC__STREAM_DECODER_INIT_STATUS_OK) {
+        return false;
+    }
+    active = true;
+    if (!FLAC__stream_decoder_process_until_end_of_metadata(decoder) || sampleRate == 0) {
+        finish();
+        return false;
+    }
+    return true;
+}
+
+uint32_t FlacDecoder::decode() {
+    if (!active) {
+        return 0;
+    }
+    // process_single 可能只处理了元数据块，直到真正输出一帧或到达文件末尾
+    decodedFrames = 0;
+    while (decodedFrames == 0) {
+        if (!FLAC__stream_decoder_process_single(decoder) ||
+            FLAC__stream_decoder_get_state(decoder) == FLAC__STREAM_DECODER_END_OF_STREAM) {
+            break;
+        }
+    }
+    return decodedFrames;
+}
+
+bool FlacDecoder::seek(const uint64_t sample) {
+    return active && FLAC__stream_decoder_seek_absolute(decoder, sample);
+}
+
+void FlacDecoder::finish() {
+    if (active) {
+        FLAC__stream_decoder_finish(decoder);
+        active = false;
+    }
+}
+
+FLAC__StreamDecoderReadStatus FlacDecoder::readCallback(const FLAC__StreamDecoder*, FLAC__byte buffer[],
+                                                        size_t* bytes, void* clientData) {
+    auto* self = static_cast<FlacDecoder*>(clientData);
+    *bytes = self->reader->read(buffer, *bytes);
+    return *bytes ? FLAC__STREAM_DECODER_READ_STATUS_CONTINUE : FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+}
+
+FLAC__StreamDecoderSeekStatus FlacDecoder::seekCallback(const FLAC__StreamDecoder*, const FLAC__uint64 offset,
+                                                        void* clientData) {
+    auto* self = static_cast<FlacDecoder*>(clientData);
+    return self->reader->seek(offset) ? FLAC__STREAM_DECODER_SEEK_STATUS_OK : FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
+}
+
+FLAC__StreamDecoderTellStatus FlacDecoder::tellCallback(const FLAC__StreamDecoder*, FLAC__uint64* offset,
+                                                        void* clientData) {
+    *offset = static_cast<FlacDecoder*>(clientData)->reader->tell();
+    return FLAC__STREAM_DECODER_TELL_STATUS_OK;
+}
+
+FLAC__StreamDecoderLengthStatus FlacDecoder::lengthCallback(const FLAC__StreamDecoder*, FLAC__uint64* length,
+                                                            void* clientData) {
+    *length = static_cast<FlacDecoder*>(clientData)->reader->size();
+    return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
+}
+
+FLAC__bool FlacDecoder::eofCallback(const FLAC__StreamDecoder*, void* clientData) {
+    return static_cast<FlacDecoder*>(clientData)->reader->isEof();
+}
+
+// 各声道平面按 BLOCK_FRAMES 帧一块交织为16位立体声：高于16位的右移截断，低于16位的左移补齐，
+// 单声道复制到两个声道，多于两个声道时只取前两个
+FLAC__StreamDecoderWriteStatus FlacDecoder::writeCallback(const FLAC__StreamDecoder*, const FLAC__Frame* frame,
+                                                          const FLAC__int32* const buffer[], void* clientData) {
+    auto* self = static_cast<FlacDecoder*>(clientData);
+    const uint32_t frames = frame->header.blocksize;
+    const int shift = static_cast<int>(frame->header.bits_per_sample) - 16;
+    const FLAC__int32* left = buffer[0];
+    const FLAC__int32* right = buffer[frame->header.channels > 1 ? 1 : 0];
+    for (uint32_t offset = 0; offset < frames; offset += BLOCK_FRAMES) {
+        const uint32_t count = frames - offset < BLOCK_FRAMES ? frames - offset : BLOCK_FRAMES;
+        int16_t* out = self->block;
+        if (shift >= 0) {
+            for (uint32_t i = offset; i < offset + count; i++) {
+                *out++ = static_cast<int16_t>(left[i] >> shift);
+                *out++ = static_cast<int16_t>(right[i] >> shift);
+            }
+        } else {
+            for (uint32_t i = offset; i < offset + count; i++) {
+                *out++ = static_cast<int16_t>(left[i] << -shift);
+                *out++ = static_cast<int16_t>(right[i] << -shift);
+            }
+        }
+        self->sink(self->block, count, self->sinkArg);
+    }
+    self->decodedFrames += frames;
+    return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+}
+
+void FlacDecoder::metadataCallback(const FLAC__StreamDecoder*, const FLAC__StreamMetadata* metadata,
+                                   void* clientData) {
+    if (metadata->type != FLAC__METADATA_TYPE_STREAMINFO) {
+        return;
+    }
+    auto* self = static_cast<FlacDecoder*>(clientData);
+    self->sampleRate = metadata->data.stream_info.sample_rate;
+    self->channels = metadata->data.stream_info.channels;
+    self->bitsPerSample = metadata->data.stream_info.bits_per_sample;
+    self->totalSamples = metadata->data.stream_info.total_samples;
+}
+
+// 失步等错误由 libFLAC 自行重新同步，这里不需要处理
+void FlacDecoder::errorCallback(const FLAC__StreamDecoder*, FLAC__StreamDecoderErrorStatus, void*) {
+}
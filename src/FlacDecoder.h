@@ -0,0 +1,74 @@
+#ifndef FLAC_DECODER_H
+#define FLAC_DECODER_H
+#include <stdint.h>
+#include "stream_decoder.h"
+#include "FileReader.h"
+
+// libFLAC 流式解码：读回调从 FileReader（FatFs）取数据，写回调把各声道的 FLAC__int32 平面
+// 按块交织并转换为16位立体声，交给 Sink 直接写入输出环，不做逐样本的 I/O
+class FlacDecoder {
+public:
+    // 每次交出 frames 帧交织的16位立体声样本，可在环满时阻塞
+    using Sink = void (*)(const int16_t* samples, uint32_t frames, void* arg);
+    static constexpr uint16_t BLOCK_FRAMES = 256;
+
+    ~FlacDecoder();
+
+    // 初始化解码器并解析到第一个音频帧之前，失败时返回 false
+    bool start(FileReader& reader, Sink sink, void* arg);
+
+    // 解码一个 FLAC 帧，返回每声道样本数；0 表示文件结束或出错
+    uint32_t decode();
+
+    // 跳到第 sample 个样本，该帧从目标样本起的部分立即经 Sink 输出
+    bool seek(uint64_t sample);
+
+    void finish();
+
+    [[nodiscard]] uint32_t getSampleRate() const {
+        return sampleRate;
+    }
+
+    [[nodiscard]] uint8_t getChannels() const {
+        return channels;
+    }
+
+    [[nodiscard]] uint8_t getBitsPerSample() const {
+        return bitsPerSample;
+    }
+
+    [[nodiscard]] uint64_t getTotalSamples() const {
+        return totalSamples;
+    }
+
+private:
+    FLAC__StreamDecoder* decoder = nullptr;
+    FileReader* reader = nullptr;
+    Sink sink = nullptr;
+    void* sinkArg = nullptr;
+    uint32_t sampleRate = 0;
+    uint8_t channels = 0;
+    uint8_t bitsPerSample = 0;
+    uint64_t totalSamples = 0;
+    uint32_t decodedFrames = 0;
+    bool active = false;
+    int16_t block[BLOCK_FRAMES * 2]{};
+
+    static FLAC__StreamDecoderReadStatus readCallback(const FLAC__StreamDecoder* decoder, FLAC__byte buffer[],
+                                                      size_t* bytes, void* clientData);
+    static FLAC__StreamDecoderSeekStatus seekCallback(const FLAC__StreamDecoder* decoder, FLAC__uint64 offset,
+                                                      void* clientData);
+    static FLAC__StreamDecoderTellStatus tellCallback(const FLAC__StreamDecoder* decoder, FLAC__uint64* offset,
+                                                      void* clientData);
+    static FLAC__StreamDecoderLengthStatus lengthCallback(const FLAC__StreamDecoder* decoder, FLAC__uint64* length,
+                                                          void* clientData);
+    static FLAC__bool eofCallback(const FLAC__StreamDecoder* decoder, void* clientData);
+    static FLAC__StreamDecoderWriteStatus writeCallback(const FLAC__StreamDecoder* decoder, const FLAC__Frame* frame,
+                                                        const FLAC__int32* const buffer[], void* clientData);
+    static void metadataCallback(const FLAC__StreamDecoder* decoder, const FLAC__StreamMetadata* metadata,
+                                 void* clientData);
+    static void errorCallback(const FLAC__StreamDecoder* decoder, FLAC__StreamDecoderErrorStatus status,
+                              void* clientData);
+};
+
+#endif // FLAC_DECODER_H
@@ -0,0 +1,74 @@
+#ifndef FOLDER_INDEX_H
+#define FOLDER_INDEX_H
+#include <stdint.h>
+#include "QueryCache.h"
+
+// 文件夹到全局曲目号区间的映射：文件夹 f 占 [firstTrack(f), firstTrack(f) + trackCount(f))。
+// 假定模块的全局序号按文件夹顺序排列（按文件夹依次拷贝文件时成立）
+class FolderIndex {
+    uint16_t first[QueryCache::MAX_FOLDERS + 1]{};
+    uint8_t folders = 0;
+    bool valid = false;
+
+public:
+    // 文件夹总数及各文件夹文件数全部就绪后才生效
+    void rebuild(const QueryCache& cache) {
+        valid = false;
+        if (!cache.folderTotal.valid) {
+            return;
+        }
+        const uint16_t total = cache.folderTotal.value;
+        const uint8_t count = total < QueryCache::MAX_FOLDERS ? total : QueryCache::MAX_FOLDERS;
+        uint16_t next = 1;
+        for (uint8_t i = 0; i < count; i++) {
+            if (!cache.folderFiles[i].valid) {
+                return;
+            }
+            first[i] = next;
+            next += cache.folderFiles[i].value;
+        }
+        first[count] = next;
+        folders = count;
+        valid = true;
+    }
+
+    [[nodiscard]] bool isValid() const {
+        return valid;
+    }
+
+    [[nodiscard]] uint8_t getFolders() const {
+        return valid ? folders : 0;
+    }
+
+    [[nodiscard]] uint16_t firstTrack(const uint8_t folder) const {
+        return valid && folder >= 1 && folder <= folders ? first[folder - 1] : 0;
+    }
+
+    [[nodiscard]] uint16_t trackCount(const uint8_t folder) const {
+        return valid && folder >= 1 && folder <= folders ? first[folder] - first[folder - 1] : 0;
+    }
+
+    [[nodiscard]] uint16_t globalIndex(const uint8_t folder, const uint16_t file) const {
+        return file >= 1 && file <= trackCount(folder) ? first[folder - 1] + file - 1 : 0;
+    }
+
+    // 全局曲目号所在的文件夹，找不到时返回0
+    [[nodiscard]] uint8_t folderOf(const uint16_t track) const {
+        if (!valid || track < 1 || track >= first[folders]) {
+            return 0;
+        }
+        uint8_t low = 0;
+        uint8_t high = folders;
+        while (high - low > 1) {
+            const uint8_t middle = (low + high) / 2;
+            if (first[middle] <= track) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        return low + 1;
+    }
+};
+
+#endif // FOLDER_INDEX_H
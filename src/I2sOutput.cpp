@@ -0,0 +1,70 @@
+#include "I2sOutput.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "audio_i2s.pio.h"
+
+static uint32_t silence[AudioRing::PERIOD_FRAMES];
+
+I2sOutput* I2sOutput::instance = nullptr;
+
+void I2sOutput::begin(AudioRing& ring, const uint32_t sampleRate) {
+    this->ring = &ring;
+    instance = this;
+    const uint offset = pio_add_program(pio, &audio_i2s_program);
+    sm = pio_claim_unused_sm(pio, true);
+    audio_i2s_program_init(pio, sm, offset, dataPin, clockPinBase);
+    setSampleRate(sampleRate);
+
+    channels[0] = dma_claim_unused_channel(true);
+    channels[1] = dma_claim_unused_channel(true);
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_config config = dma_channel_get_default_config(channels[i]);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+        channel_config_set_read_increment(&config, true);
+        channel_config_set_write_increment(&config, false);
+        channel_config_set_dreq(&config, pio_get_dreq(pio, sm, true));
+        channel_config_set_chain_to(&config, channels[i ^ 1]);
+        dma_channel_configure(channels[i], &config, &pio->txf[sm], silence, AudioRing::PERIOD_FRAMES, false);
+        dma_channel_set_irq0_enabled(channels[i], true);
+    }
+    irq_add_shared_handler(DMA_IRQ_0, dmaIrq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+    dma_channel_start(channels[0]);
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+// 每个位时钟周期2条指令、每帧32位，状态机时钟为采样率的64倍
+void I2sOutput::setSampleRate(const uint32_t sampleRate) {
+    if (sampleRate == this->sampleRate) {
+        return;
+    }
+    this->sampleRate = sampleRate;
+    pio_sm_set_clkdiv(pio, sm, static_cast<float>(clock_get_hz(clk_sys)) / (sampleRate * 64.0f));
+}
+
+// 通道刚发送完毕，它链接的另一通道已开始发送；为它装入下一周期，完成后由另一通道链接触发
+void I2sOutput::refill(const uint8_t index) {
+    if (owned[index]) {
+        ring->release();
+        owned[index] = false;
+    }
+    const uint32_t* next = ring->acquireRead();
+    owned[index] = next != nullptr;
+    dma_channel_set_read_addr(channels[index], next ? next : silence, false);
+}
+
+void I2sOutput::dmaIrq() {
+    I2sOutput* self = instance;
+    bool released = false;
+    for (uint8_t i = 0; i < 2; i++) {
+        if (dma_channel_get_irq0_status(self->channels[i])) {
+            dma_channel_acknowledge_irq0(self->channels[i]);
+            released |= self->owned[i];
+            self->refill(i);
+        }
+    }
+    if (released && self->notify) {
+        self->notify(self->notifyArg);
+    }
+}
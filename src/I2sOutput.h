@@ -0,0 +1,52 @@
+#ifndef I2S_OUTPUT_H
+#define I2S_OUTPUT_H
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "PcmRing.h"
+
+// 输出周期576帧（44.1kHz 下约13ms），共8个周期，约105ms的缓冲
+using AudioRing = PcmRing<576, 8>;
+
+// PIO I2S 输出：两个 DMA 通道互相链接轮流发送，一个通道完成时在中断中为它装入环中的下一周期，
+// 此时另一个通道已在无缝发送。环中没有数据时发送静音周期，欠载由环在播放期间计数
+class I2sOutput {
+public:
+    using NotifyCallback = void (*)(void* arg);
+
+    I2sOutput(PIO pio, const uint dataPin, const uint clockPinBase)
+        : pio(pio), dataPin(dataPin), clockPinBase(clockPinBase) {
+    }
+
+    // 在需要处理 DMA 中断的核心上调用；LRCLK 为 clockPinBase + 1
+    void begin(AudioRing& ring, uint32_t sampleRate);
+
+    void setSampleRate(uint32_t sampleRate);
+
+    // DMA 归还一个周期后调用，用于唤醒解码任务（在中断上下文中执行）
+    void setNotify(const NotifyCallback callback, void* arg) {
+        notifyArg = arg;
+        notify = callback;
+    }
+
+    [[nodiscard]] uint32_t getSampleRate() const {
+        return sampleRate;
+    }
+
+private:
+    PIO pio;
+    uint dataPin;
+    uint clockPinBase;
+    uint sm = 0;
+    uint channels[2]{};
+    bool owned[2]{}; // 通道当前发送的是环中的周期（而非静音）
+    AudioRing* ring = nullptr;
+    uint32_t sampleRate = 0;
+    NotifyCallback notify = nullptr;
+    void* notifyArg = nullptr;
+
+    void refill(uint8_t index);
+    static I2sOutput* instance;
+    static void dmaIrq();
+};
+
+#endif // I2S_OUTPUT_H
@@ -0,0 +1,197 @@
+#define MINIMP3_IMPLEMENTATION
+#include "Mp3Decoder.h"
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t be32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) << 24 | data[1] << 16 | data[2] << 8 | data[3];
+}
+
+static uint32_t syncsafe(const uint8_t* data) {
+    return (data[0] & 0x7F) << 21 | (data[1] & 0x7F) << 14 | (data[2] & 0x7F) << 7 | (data[3] & 0x7F);
+}
+
+// 把 ID3v2 文本转为 ASCII，各字符串的结尾保留为 '\0'；UTF-16 按各自的 BOM 判断字节序，非 ASCII 字符记为 '?'
+static void narrow(const uint8_t* text, const uint32_t length, const uint8_t encoding, char* out, const size_t size) {
+    size_t written = 0;
+    if (encoding == 1 || encoding == 2) {
+        bool bigEndian = encoding == 2;
+        for (uint32_t i = 0; i + 1 < length && written + 1 < size; i += 2) {
+            const uint16_t unit = bigEndian ? text[i] << 8 | text[i + 1] : text[i] | text[i + 1] << 8;
+            if (unit == 0xFFFE) {
+                bigEndian = !bigEndian;
+            } else if (unit != 0xFEFF) {
+                out[written++] = unit < 0x80 ? static_cast<char>(unit) : '?';
+            }
+        }
+    } else {
+        for (uint32_t i = 0; i < length && written + 1 < size; i++) {
+            out[written++] = text[i] < 0x80 ? static_cast<char>(text[i]) : '?';
+        }
+    }
+    out[written] = '\0';
+}
+
+void Mp3Decoder::start(FileReader& reader) {
+    mp3dec_init(&decoder);
+    info = {};
+    frameNumber = 0;
+    nextFrame = 0;
+    firstAudioFrame = 0;
+    trimStart = 0;
+    trimEnd = NO_END;
+    pcmOffset = 0;
+    reader.refill();
+    const uint8_t* header = reader.data();
+    if (reader.available() >= 10 && header[0] == 'I' && header[1] == 'D' && header[2] == '3') {
+        // 标签长度为4个7位的同步安全整数，不含10字节标签头；标志位4表示带10字节标签尾
+        uint32_t length = 10 + syncsafe(header + 6);
+        if (header[5] & 0x10) {
+            length += 10;
+        }
+        // 只解析已在缓冲区中的部分，封面图片之后的帧忽略
+        parseId3(header, length < reader.available() ? length : reader.available());
+        if (length < reader.available()) {
+            reader.consume(length);
+        } else {
+            reader.seek(length);
+        }
+    }
+    parseInfoFrame(reader);
+}
+
+void Mp3Decoder::restart(const uint32_t frameNumber) {
+    mp3dec_init(&decoder);
+    info = {};
+    nextFrame = frameNumber;
+}
+
+uint32_t Mp3Decoder::decode(FileReader& reader) {
+    while (true) {
+        if (reader.available() < FileReader::BUFFER_SIZE / 2) {
+            reader.refill();
+        }
+        const size_t available = reader.available();
+        if (available == 0) {
+            return 0;
+        }
+        const int count = mp3dec_decode_frame(&decoder, reader.data(), static_cast<int>(available), samples, &info);
+        if (info.frame_bytes > 0) {
+            // 有样本时为一帧；无样本时为比特池不足的帧（以帧头开始）或被跳过的非音频数据
+            frameOffset = reader.tell();
+            const bool frame = count > 0 || hdr_valid(reader.data());
+            reader.consume(info.frame_bytes);
+            if (count == 0) {
+                nextFrame += frame ? 1 : 0;
+                continue;
+            }
+            frameNumber = nextFrame++;
+            if (frameNumber < firstAudioFrame) {
+                continue;
+            }
+            // 与有效范围求交：整帧在延迟内时丢弃，到了末尾填充时结束
+            const uint64_t first = static_cast<uint64_t>(frameNumber - firstAudioFrame) * count;
+            if (first >= trimEnd) {
+                return 0;
+            }
+            const uint64_t from = trimStart > first ? trimStart - first : 0;
+            if (from >= static_cast<uint64_t>(count)) {
+                continue;
+            }
+            const uint64_t to = trimEnd - first < static_cast<uint64_t>(count) ? trimEnd - first : count;
+            pcmOffset = static_cast<uint16_t>(from);
+            return static_cast<uint32_t>(to - from);
+        }
+        // 缓冲区中找不到帧：已是满缓冲或文件末尾时整段丢弃，否则补充数据后再试
+        if (available == FileReader::BUFFER_SIZE || reader.tell() + available >= reader.size()) {
+            reader.consume(available);
+        } else {
+            reader.refill();
+        }
+    }
+}
+
+// iTunes 在描述为 iTunSMPB 的 COMM 帧中以十六进制记录：0、编码器延迟、末尾填充、有效样本数
+void Mp3Decoder::parseId3(const uint8_t* tag, const uint32_t length) {
+    const uint8_t version = tag[3];
+    const uint8_t headerBytes = version == 2 ? 6 : 10;
+    uint32_t at = 10;
+    if (version >= 3 && (tag[5] & 0x40) && at + 4 <= length) {
+        at += version == 4 ? syncsafe(tag + at) : be32(tag + at) + 4;
+    }
+    while (at + headerBytes <= length && tag[at] != 0) {
+        const uint8_t* frame = tag + at;
+        const uint32_t size = version == 2 ? frame[3] << 16 | frame[4] << 8 | frame[5]
+                              : version == 4 ? syncsafe(frame + 4)
+                                             : be32(frame + 4);
+        if (size > length - at - headerBytes) {
+            return;
+        }
+        const bool comment = version == 2 ? memcmp(frame, "COM", 3) == 0 : memcmp(frame, "COMM", 4) == 0;
+        if (comment && size > 4) {
+            // 编码、3字节语言、描述与正文
+            char text[64];
+            narrow(frame + headerBytes + 4, size - 4, frame[headerBytes], text, sizeof(text));
+            const size_t description = strlen(text);
+            if (strcmp(text, "iTunSMPB") == 0 && description + 1 < sizeof(text)) {
+                char* field = text + description + 1;
+                strtoul(field, &field, 16);
+                const uint32_t delay = strtoul(field, &field, 16);
+                strtoul(field, &field, 16);
+                setTrim(delay, strtoull(field, nullptr, 16));
+                return;
+            }
+        }
+        at += headerBytes + size;
+    }
+}
+
+// Xing/Info 标签在边信息之后；LAME 标签紧随其后，第21字节起为12位编码器延迟和12位末尾填充。
+// LAME 标签优先于 iTunSMPB
+void Mp3Decoder::parseInfoFrame(FileReader& reader) {
+    const size_t available = reader.refill();
+    const uint8_t* data = reader.data();
+    size_t at = 0;
+    while (at + 4 <= available && !hdr_valid(data + at)) {
+        at++;
+    }
+    const uint8_t* frame = data + at;
+    const size_t length = available - at;
+    if (length < 4) {
+        return;
+    }
+    const uint32_t xing = 4 + (HDR_TEST_MPEG1(frame) ? (HDR_IS_MONO(frame) ? 17 : 32) : (HDR_IS_MONO(frame) ? 9 : 17));
+    if (xing + 8 > length || (memcmp(frame + xing, "Xing", 4) != 0 && memcmp(frame + xing, "Info", 4) != 0)) {
+        return;
+    }
+    firstAudioFrame = 1;
+    const uint32_t flags = be32(frame + xing + 4);
+    size_t field = xing + 8;
+    uint32_t frames = 0;
+    // 截断的 Info 帧：各字段读取前都检查仍在缓冲区内
+    if (flags & 1) {
+        if (field + 4 > length) {
+            return;
+        }
+        frames = be32(frame + field);
+        field += 4;
+    }
+    field += (flags & 2 ? 4 : 0) + (flags & 4 ? 100 : 0) + (flags & 8 ? 4 : 0);
+    if (field + 24 > length) {
+        return;
+    }
+    const uint8_t* lame = frame + field;
+    if (memcmp(lame, "LAME", 4) != 0 && memcmp(lame, "Lavc", 4) != 0 && memcmp(lame, "Lavf", 4) != 0) {
+        return;
+    }
+    const uint32_t delay = lame[21] << 4 | lame[22] >> 4;
+    const uint32_t padding = (lame[22] & 0x0F) << 8 | lame[23];
+    const uint64_t total = static_cast<uint64_t>(frames) * hdr_frame_samples(frame);
+    setTrim(delay, total > delay + padding ? total - delay - padding : 0);
+}
+
+// validSamples 为0时只裁开头
+void Mp3Decoder::setTrim(const uint32_t delay, const uint64_t validSamples) {
+    trimStart = delay + DECODER_DELAY;
+    trimEnd = validSamples ? trimStart + validSamples : NO_END;
+}
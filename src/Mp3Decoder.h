@@ -0,0 +1,78 @@
+#ifndef MP3_DECODER_H
+#define MP3_DECODER_H
+#include <stdint.h>
+#include "minimp3.h"
+#include "FileReader.h"
+
+// minimp3 帧解码：直接在 FileReader 的缓冲区上解析，每次输出一帧交织的16位样本。
+// 文件带 LAME 标签或 iTunSMPB 注释时按其中的编码器延迟与末尾填充裁剪输出（另加 minimp3 的529个样本解码延迟），
+// 并丢弃 Xing/Info 帧，使连续的曲目首尾按样本衔接；裁剪只取决于帧号，定位后同样适用
+class Mp3Decoder {
+public:
+    static constexpr uint16_t DECODER_DELAY = 529;
+
+    // 重置解码器，读取无缝播放信息并跳过文件开头的 ID3v2 标签
+    void start(FileReader& reader);
+
+    // 从 reader 的当前位置（帧的起点）重新开始解码，frameNumber 为该帧的帧号
+    void restart(uint32_t frameNumber);
+
+    // 解出下一帧，返回裁剪后的每声道样本数；0 表示文件结束或到了末尾填充
+    uint32_t decode(FileReader& reader);
+
+    [[nodiscard]] const int16_t* pcm() const {
+        return samples + pcmOffset * info.channels;
+    }
+
+    [[nodiscard]] uint8_t getChannels() const {
+        return info.channels;
+    }
+
+    [[nodiscard]] uint32_t getSampleRate() const {
+        return info.hz;
+    }
+
+    [[nodiscard]] uint16_t getBitrateKbps() const {
+        return info.bitrate_kbps;
+    }
+
+    // 上一次 decode() 输出的帧在文件中的起点（含帧前被跳过的数据）；因末尾填充返回0时为被裁掉的帧
+    [[nodiscard]] uint32_t getFrameOffset() const {
+        return frameOffset;
+    }
+
+    // 上一次 decode() 输出的帧的帧号，从第一帧起算，包括因比特池不足未输出样本的帧
+    [[nodiscard]] uint32_t getFrameNumber() const {
+        return frameNumber;
+    }
+
+    // 裁剪后第 sample 个样本所在帧的帧号
+    [[nodiscard]] uint32_t frameOf(const uint64_t sample, const uint16_t samplesPerFrame) const {
+        return static_cast<uint32_t>((sample + trimStart) / samplesPerFrame) + firstAudioFrame;
+    }
+
+    // 有编码器延迟与填充信息，首尾都已裁剪
+    [[nodiscard]] bool isGapless() const {
+        return trimEnd != NO_END;
+    }
+
+private:
+    mp3dec_t decoder{};
+    mp3dec_frame_info_t info{};
+    mp3d_sample_t samples[MINIMP3_MAX_SAMPLES_PER_FRAME]{};
+    uint32_t frameOffset = 0;
+    uint32_t frameNumber = 0;
+    uint32_t nextFrame = 0;
+    // 有效样本范围，以 Xing/Info 帧之后第一帧的第一个输出样本为0
+    static constexpr uint64_t NO_END = UINT64_MAX;
+    uint8_t firstAudioFrame = 0;
+    uint64_t trimStart = 0;
+    uint64_t trimEnd = NO_END;
+    uint16_t pcmOffset = 0;
+
+    void parseId3(const uint8_t* tag, uint32_t length);
+    void parseInfoFrame(FileReader& reader);
+    void setTrim(uint32_t delay, uint64_t validSamples);
+};
+
+#endif // MP3_DECODER_H
@@ -0,0 +1,56 @@
+#ifndef PACKED_MATH_H
+#define PACKED_MATH_H
+#include <stdint.h>
+
+// 打包16位（hi<<16 | lo）运算：Cortex-M33 上用 DSP 扩展指令，其他平台用等价的 C++ 实现
+
+static inline int32_t high(const uint32_t word) {
+    return static_cast<int16_t>(word >> 16);
+}
+
+static inline int32_t low(const uint32_t word) {
+    return static_cast<int16_t>(word);
+}
+
+static inline uint32_t pack(const int32_t high, const int32_t low) {
+    return static_cast<uint32_t>(high) << 16 | static_cast<uint16_t>(low);
+}
+
+// 32x16 位乘取高32位，GCC 在 Cortex-M33 上直接生成 SMULWT/SMULWB
+static inline int32_t smulwt(const int32_t a, const uint32_t b) {
+    return static_cast<int32_t>(static_cast<int64_t>(a) * high(b) >> 16);
+}
+
+static inline int32_t smulwb(const int32_t a, const uint32_t b) {
+    return static_cast<int32_t>(static_cast<int64_t>(a) * low(b) >> 16);
+}
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#include <arm_acle.h>
+
+static inline int32_t smlad(const uint32_t a, const uint32_t b, const int32_t accumulator) {
+    return __smlad(static_cast<int16x2_t>(a), static_cast<int16x2_t>(b), accumulator);
+}
+
+static inline int64_t smlald(const uint32_t a, const uint32_t b, const int64_t accumulator) {
+    return __smlald(static_cast<int16x2_t>(a), static_cast<int16x2_t>(b), accumulator);
+}
+
+static inline int32_t ssat16(const int64_t value) {
+    return __ssat(static_cast<int32_t>(value), 16);
+}
+#else
+static inline int32_t smlad(const uint32_t a, const uint32_t b, const int32_t accumulator) {
+    return accumulator + high(a) * high(b) + low(a) * low(b);
+}
+
+static inline int64_t smlald(const uint32_t a, const uint32_t b, const int64_t accumulator) {
+    return accumulator + high(a) * high(b) + low(a) * low(b);
+}
+
+static inline int32_t ssat16(const int64_t value) {
+    return value > 32767 ? 32767 : value < -32768 ? -32768 : static_cast<int32_t>(value);
+}
+#endif
+
+#endif // PACKED_MATH_H
@@ -0,0 +1,194 @@
+#ifndef PCM_RING_H
+#define PCM_RING_H
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// 单生产者/单消费者的PCM周期环形缓冲：解码任务按周期写入，DMA 中断以整周期为单位读出，全程无锁。
+// 每帧一个32位字，高半字为左声道、低半字为右声道，与 I2S 输出的移位顺序一致。
+// 生产者与消费者各自修改的索引放在不同的缓存行，避免在多核主机上互相失效
+template <uint16_t FRAMES, uint8_t PERIODS>
+class PcmRing {
+    static_assert((PERIODS & (PERIODS - 1)) == 0, "PERIODS must be a power of two");
+    static constexpr size_t CACHE_LINE = 64;
+
+public:
+    static constexpr uint16_t PERIOD_FRAMES = FRAMES;
+    static constexpr uint8_t PERIOD_COUNT = PERIODS;
+    // 每 HISTORY_WINDOW 个周期记录一次窗口内的最低水位，保留最近 HISTORY_SIZE 个窗口
+    static constexpr uint16_t HISTORY_WINDOW = 64;
+    static constexpr uint8_t HISTORY_SIZE = 16;
+
+    // 生产者：周期写满、发布之前就地处理（音效等），在 write()/flush() 的调用者上下文中执行
+    using PeriodHook = void (*)(uint32_t* period, uint16_t frames, void* arg);
+
+    void setPeriodHook(const PeriodHook hook, void* arg) {
+        hookArg = arg;
+        this->hook = hook;
+    }
+
+    // 生产者：取下一个空闲周期直接写入，写满后 commit()；环满时返回 nullptr 并计一次溢出
+    uint32_t* acquireWrite() {
+        const uint16_t t = tail.load(std::memory_order_relaxed);
+        if (static_cast<uint16_t>(t - head.load(std::memory_order_acquire)) == PERIODS) {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return periods[t % PERIODS];
+    }
+
+    // 生产者：发布 acquireWrite() 取得的周期
+    void commit() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 生产者：写入交织的16位样本（单声道复制到两个声道），返回实际写入的帧数，环满时少写。
+    // 不足一个周期的部分留在写入中的周期里，由后续写入或 flush() 补齐
+    uint32_t write(const int16_t* samples, const uint32_t frames, const uint8_t channels) {
+        uint32_t written = 0;
+        while (written < frames) {
+            uint32_t* period = acquireWrite();
+            if (period == nullptr) {
+                break;
+            }
+            while (fill < FRAMES && written < frames) {
+                const int16_t* frame = samples + written * channels;
+                const uint16_t right = channels > 1 ? frame[1] : frame[0];
+                period[fill++] = static_cast<uint32_t>(static_cast<uint16_t>(frame[0])) << 16 | right;
+                written++;
+            }
+            if (fill == FRAMES) {
+                fill = 0;
+                publish(period);
+            }
+        }
+        return written;
+    }
+
+    // 生产者：用静音补齐写入中的周期并发布（曲目结束时），环满时返回 false
+    bool flush() {
+        if (fill == 0) {
+            return true;
+        }
+        uint32_t* period = acquireWrite();
+        if (period == nullptr) {
+            return false;
+        }
+        while (fill < FRAMES) {
+            period[fill++] = 0;
+        }
+        fill = 0;
+        publish(period);
+        return true;
+    }
+
+    // 生产者：还能写入的帧数
+    [[nodiscard]] uint32_t freeFrames() const {
+        const uint16_t used = tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire);
+        return static_cast<uint32_t>(PERIODS - used) * FRAMES - fill;
+    }
+
+    // 生产者：丢弃此刻之前已发布、尚未交给 DMA 的周期（切歌时），之后写入的周期不受影响。
+    // 实际丢弃由消费者在 DMA 持有的周期全部归还后执行，期间输出最多两个周期的静音
+    void discard() {
+        dropUntil.store(tail.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        dropPending.store(true, std::memory_order_release);
+    }
+
+    // 生产者：有数据在播放时置位，此期间消费者取不到周期才计为欠载（曲目之间的空闲不算）
+    void setStreaming(const bool enabled) {
+        streaming.store(enabled, std::memory_order_relaxed);
+    }
+
+    // 消费者：取下一个已写满的周期交给 DMA，没有时返回 nullptr
+    const uint32_t* acquireRead() {
+        uint16_t r = reserved.load(std::memory_order_relaxed);
+        if (dropPending.load(std::memory_order_acquire)) {
+            if (head.load(std::memory_order_relaxed) != r) {
+                return nullptr;
+            }
+            const uint16_t until = dropUntil.load(std::memory_order_relaxed);
+            // 丢弃点在 reserved 之前说明这些周期已经播出
+            if (static_cast<uint16_t>(until - r) <= PERIODS) {
+                r = until;
+                reserved.store(r, std::memory_order_relaxed);
+                head.store(r, std::memory_order_release);
+            }
+            dropPending.store(false, std::memory_order_relaxed);
+        }
+        if (r == tail.load(std::memory_order_acquire)) {
+            if (streaming.load(std::memory_order_relaxed)) {
+                underruns.fetch_add(1, std::memory_order_relaxed);
+            }
+            return nullptr;
+        }
+        reserved.store(r + 1, std::memory_order_relaxed);
+        return periods[r % PERIODS];
+    }
+
+    // 消费者：归还最早取出的周期，并记录归还前的水位（已写满未读取的周期数）
+    void release() {
+        const uint8_t level = readyPeriods();
+        if (level < windowLow) {
+            windowLow = level;
+        }
+        if (++windowCount == HISTORY_WINDOW) {
+            const uint8_t index = historyCount.load(std::memory_order_relaxed);
+            history[index % HISTORY_SIZE].store(windowLow, std::memory_order_relaxed);
+            historyCount.store(index + 1, std::memory_order_release);
+            windowLow = PERIODS;
+            windowCount = 0;
+        }
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    [[nodiscard]] uint16_t readyPeriods() const {
+        return tail.load(std::memory_order_acquire) - reserved.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint32_t getUnderruns() const {
+        return underruns.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint32_t getOverruns() const {
+        return overruns.load(std::memory_order_relaxed);
+    }
+
+    // 最近的水位记录，由旧到新写入 out（最多 HISTORY_SIZE 项），返回项数
+    uint8_t watermarkHistory(uint8_t* out) const {
+        const uint8_t count = historyCount.load(std::memory_order_acquire);
+        const uint8_t valid = count < HISTORY_SIZE ? count : HISTORY_SIZE;
+        for (uint8_t i = 0; i < valid; i++) {
+            out[i] = history[static_cast<uint8_t>(count - valid + i) % HISTORY_SIZE].load(std::memory_order_relaxed);
+        }
+        return valid;
+    }
+
+private:
+    void publish(uint32_t* period) {
+        if (hook) {
+            hook(period, FRAMES, hookArg);
+        }
+        commit();
+    }
+
+    alignas(CACHE_LINE) uint32_t periods[PERIODS][FRAMES]{};
+    // 均为周期计数：[head, reserved) 正被 DMA 读取，[reserved, tail) 已写满待读取
+    alignas(CACHE_LINE) std::atomic<uint16_t> tail{0};
+    uint16_t fill = 0; // 写入中的周期已填帧数
+    PeriodHook hook = nullptr;
+    void* hookArg = nullptr;
+    std::atomic<bool> streaming{false};
+    std::atomic<uint32_t> overruns{0};
+    std::atomic<uint16_t> dropUntil{0};
+    std::atomic<bool> dropPending{false};
+    alignas(CACHE_LINE) std::atomic<uint16_t> head{0};
+    std::atomic<uint16_t> reserved{0};
+    std::atomic<uint32_t> underruns{0};
+    uint8_t windowLow = PERIODS;
+    uint16_t windowCount = 0;
+    std::atomic<uint8_t> historyCount{0};
+    std::atomic<uint8_t> history[HISTORY_SIZE]{};
+};
+
+#endif // PCM_RING_H
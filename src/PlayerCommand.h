@@ -0,0 +1,155 @@
+#ifndef PLAYER_COMMAND_H
+#define PLAYER_COMMAND_H
+#include "PlayerTF16P.h"
+
+// 播放器控制命令枚举
+enum PlayerCommand {
+    CMD_PLAY,
+    CMD_PAUSE,
+    CMD_STOP,
+    CMD_NEXT,
+    CMD_PREV,
+    CMD_VOL_UP,
+    CMD_VOL_DOWN,
+    CMD_WAKE // 用户开始操作，预热待机中的模块
+};
+
+// 将一批相对命令合并为最少的绝对命令：连续音量键合并为一次 setVolume，
+// 连续切歌合并为一次 playTrack，PLAY 之后的 PAUSE 相互抵消
+class CommandCoalescer {
+    enum class TrackMode : uint8_t {
+        NONE, RELATIVE, FROM_FIRST
+    };
+
+    enum class Transport : uint8_t {
+        NONE, PAUSED, STOPPED
+    };
+
+    int16_t volumeDelta = 0;
+    int16_t trackDelta = 0;
+    TrackMode trackMode = TrackMode::NONE;
+    Transport transport = Transport::NONE;
+    uint16_t wakes = 0;
+    uint16_t batched = 0;
+    uint32_t received = 0;
+    uint32_t emitted = 0;
+    // 不会产生帧的唤醒：模块已醒着，或同一批中第一次之后的唤醒。不算作合并省去的帧
+    uint32_t noops = 0;
+    // 队列已满被播放器拒绝的命令：既未发出也不是合并省去的
+    uint32_t rejected = 0;
+
+    // 下发一条命令：只有返回有效句柄且未并入队列中待发的同类帧时才算新帧
+    template <typename Send>
+    uint8_t issue(const PlayerTF16P& player, Send send) {
+        const uint32_t collapsed = player.getCollapsedFrames();
+        if (send() == INVALID_COMMAND) {
+            rejected++;
+            return 0;
+        }
+        return player.getCollapsedFrames() == collapsed ? 1 : 0;
+    }
+
+public:
+    void add(const PlayerCommand cmd) {
+        received++;
+        batched++;
+        switch (cmd) {
+        case CMD_PLAY:
+            trackMode = TrackMode::FROM_FIRST;
+            trackDelta = 0;
+            transport = Transport::NONE;
+            break;
+        case CMD_PAUSE:
+            if (trackMode == TrackMode::FROM_FIRST && trackDelta == 0) {
+                trackMode = TrackMode::NONE;
+            } else {
+                transport = Transport::PAUSED;
+            }
+            break;
+        case CMD_STOP:
+            trackMode = TrackMode::NONE;
+            trackDelta = 0;
+            transport = Transport::STOPPED;
+            break;
+        case CMD_NEXT:
+        case CMD_PREV:
+            if (trackMode == TrackMode::NONE) {
+                trackMode = TrackMode::RELATIVE;
+            }
+            trackDelta += cmd == CMD_NEXT ? 1 : -1;
+            transport = Transport::NONE;
+            break;
+        case CMD_VOL_UP:
+            volumeDelta++;
+            break;
+        case CMD_VOL_DOWN:
+            volumeDelta--;
+            break;
+        case CMD_WAKE:
+            wakes++;
+            break;
+        }
+    }
+
+    [[nodiscard]] bool isEmpty() const {
+        return batched == 0;
+    }
+
+    // 按合并结果向播放器下发命令，返回实际下发的帧数
+    uint8_t flush(PlayerTF16P& player) {
+        uint8_t frames = 0;
+        if (wakes > 0) {
+            const bool woke = player.prewarm() != INVALID_COMMAND;
+            frames += woke;
+            noops += wakes - woke;
+        }
+        if (volumeDelta != 0) {
+            const int target = player.getVolume() + volumeDelta;
+            const uint8_t volume = target < 0 ? 0 : target > 30 ? 30 : target;
+            frames += issue(player, [&] { return player.setVolume(volume); });
+        }
+        if (trackMode != TrackMode::NONE) {
+            const int base = trackMode == TrackMode::FROM_FIRST ? 1 : player.getTrack();
+            const int total = player.getTrackTotal();
+            int target = base + trackDelta;
+            if (target < 1) {
+                target = 1;
+            } else if (total > 0 && target > total) {
+                target = total;
+            }
+            frames += issue(player, [&] { return player.playTrack(target); });
+        }
+        if (transport == Transport::PAUSED) {
+            frames += issue(player, [&] { return player.pause(); });
+        } else if (transport == Transport::STOPPED) {
+            frames += issue(player, [&] { return player.stop(); });
+        }
+        emitted += frames;
+        volumeDelta = 0;
+        trackDelta = 0;
+        trackMode = TrackMode::NONE;
+        transport = Transport::NONE;
+        wakes = 0;
+        batched = 0;
+        return frames;
+    }
+
+    [[nodiscard]] uint32_t getReceived() const {
+        return received;
+    }
+
+    [[nodiscard]] uint32_t getEmitted() const {
+        return emitted;
+    }
+
+    [[nodiscard]] uint32_t getRejected() const {
+        return rejected;
+    }
+
+    // 逐条执行时本应发出、经合并（含播放器并入队列中的同类帧）省去的帧数
+    [[nodiscard]] uint32_t getSavedFrames() const {
+        return received - emitted - batched - noops - rejected;
+    }
+};
+
+#endif // PLAYER_COMMAND_H
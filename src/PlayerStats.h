@@ -0,0 +1,123 @@
+#ifndef PLAYER_STATS_H
+#define PLAYER_STATS_H
+#include <stdint.h>
+#include <stdio.h>
+
+// 对数分桶的延迟直方图：第 i 桶统计 [2^i, 2^(i+1)) 微秒，最后一桶收纳更长的值
+struct LatencyHistogram {
+    static constexpr uint8_t BUCKETS = 20;
+    uint32_t counts[BUCKETS]{};
+    uint32_t samples = 0;
+    uint32_t maxUs = 0;
+    uint64_t totalUs = 0;
+
+    void record(const uint32_t us) {
+        uint8_t bucket = us ? 31 - __builtin_clz(us) : 0;
+        if (bucket >= BUCKETS) {
+            bucket = BUCKETS - 1;
+        }
+        counts[bucket]++;
+        samples++;
+        totalUs += us;
+        if (us > maxUs) {
+            maxUs = us;
+        }
+    }
+
+    // 返回第 p 百分位所在桶的上界（微秒）
+    [[nodiscard]] uint32_t percentileUs(const uint8_t p) const {
+        const uint32_t rank = (static_cast<uint64_t>(samples) * p + 99) / 100;
+        uint32_t seen = 0;
+        for (uint8_t i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank && seen > 0) {
+                return i == BUCKETS - 1 ? maxUs : (2u << i) - 1;
+            }
+        }
+        return 0;
+    }
+
+    [[nodiscard]] uint32_t meanUs() const {
+        return samples ? totalUs / samples : 0;
+    }
+};
+
+// 播放器串口链路的统计快照
+struct PlayerStats {
+    static constexpr uint8_t OPCODES = 12;
+    // opcodes[i] 对应 latency[i] 的命令字，0 表示未使用；超出容量的命令字计入最后一项
+    uint8_t opcodes[OPCODES]{};
+    LatencyHistogram latency[OPCODES];
+    // 连播时从收到结束帧到下一曲播放命令被应答的时间
+    LatencyHistogram gapLatency;
+    // 待机后第一次播放/继续命令入队到被应答的时间
+    LatencyHistogram resumeLatency;
+    uint32_t standbys = 0;
+    uint32_t sequencedTracks = 0;
+    uint32_t timeouts = 0;
+    uint32_t failures = 0;
+    uint32_t retries = 0;
+    uint32_t reconciliations = 0;
+    uint32_t checksumErrors = 0;
+    uint32_t discardedBytes = 0;
+    uint32_t frameOverruns = 0;
+    uint32_t collapsedFrames = 0;
+    uint32_t bytesIn = 0;
+    uint32_t bytesOut = 0;
+    // 上电（time_us_64 起点）到模块上线、到第一次开始播放的时间，0 表示尚未发生
+    uint32_t onlineMs = 0;
+    uint32_t firstAudioMs = 0;
+    uint16_t queueHighWater = 0;
+    uint16_t frameQueueHighWater = 0;
+
+    LatencyHistogram& histogramFor(const uint8_t opcode) {
+        for (uint8_t i = 0; i < OPCODES - 1; i++) {
+            if (opcodes[i] == opcode) {
+                return latency[i];
+            }
+            if (opcodes[i] == 0) {
+                opcodes[i] = opcode;
+                return latency[i];
+            }
+        }
+        opcodes[OPCODES - 1] = 0xFF;
+        return latency[OPCODES - 1];
+    }
+
+    void print() const {
+        printf("player link: out %lu B, in %lu B, timeouts %lu, failures %lu, retries %lu\n",
+               static_cast<unsigned long>(bytesOut), static_cast<unsigned long>(bytesIn),
+               static_cast<unsigned long>(timeouts), static_cast<unsigned long>(failures),
+               static_cast<unsigned long>(retries));
+        printf("  checksum errors %lu, discarded bytes %lu, frame overruns %lu, collapsed %lu\n",
+               static_cast<unsigned long>(checksumErrors), static_cast<unsigned long>(discardedBytes),
+               static_cast<unsigned long>(frameOverruns), static_cast<unsigned long>(collapsedFrames));
+        printf("  queue high water %u, frame queue high water %u, reconciliations %lu\n", queueHighWater,
+               frameQueueHighWater, static_cast<unsigned long>(reconciliations));
+        printf("  boot: module online at %lums, first audio at %lums\n", static_cast<unsigned long>(onlineMs),
+               static_cast<unsigned long>(firstAudioMs));
+        if (gapLatency.samples) {
+            printf("  gapless: %lu tracks, finish->next p50<=%luus max=%luus\n",
+                   static_cast<unsigned long>(sequencedTracks), static_cast<unsigned long>(gapLatency.percentileUs(50)),
+                   static_cast<unsigned long>(gapLatency.maxUs));
+        }
+        if (resumeLatency.samples) {
+            printf("  standby: %lu times, resume->sound p50<=%luus p99<=%luus max=%luus\n",
+                   static_cast<unsigned long>(standbys), static_cast<unsigned long>(resumeLatency.percentileUs(50)),
+                   static_cast<unsigned long>(resumeLatency.percentileUs(99)),
+                   static_cast<unsigned long>(resumeLatency.maxUs));
+        }
+        for (uint8_t i = 0; i < OPCODES; i++) {
+            const LatencyHistogram& h = latency[i];
+            if (opcodes[i] == 0 || h.samples == 0) {
+                continue;
+            }
+            printf("  cmd 0x%02X: n=%lu mean=%luus p50<=%luus p99<=%luus max=%luus\n", opcodes[i],
+                   static_cast<unsigned long>(h.samples), static_cast<unsigned long>(h.meanUs()),
+                   static_cast<unsigned long>(h.percentileUs(50)), static_cast<unsigned long>(h.percentileUs(99)),
+                   static_cast<unsigned long>(h.maxUs));
+        }
+    }
+};
+
+#endif // PLAYER_STATS_H
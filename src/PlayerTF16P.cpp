@@ -0,0 +1,788 @@
+#include "PlayerTF16P.h"
+#include "hardware/irq.h"
+#if PLAYER_TF16P_EMULATOR
+#include "TF16PEmulator.h"
+#endif
+
+CommandHandle PlayerTF16P::sendCommand(const TF16PFrame& frame) {
+    const uint8_t cmd = frame.command();
+    // 查询不算用户操作，不推迟待机；其他命令在待机时先排入唤醒帧
+    if (!isQueryCommand(cmd) && cmd != STANDBY && cmd != WAKEUP) {
+        lastActivityAt = time_us_64();
+        if (asleep) {
+            wake();
+        }
+        if (wokeFromStandby && (cmd == PLAY || cmd == RESUME || cmd == PLAY_FOLDER || cmd == PLAY_LARGE_FOLDER ||
+                                cmd == LOOP_FOLDER)) {
+            wokeFromStandby = false;
+            resumeAt = lastActivityAt;
+        }
+    }
+    // 队尾尚未发送的同类绝对命令直接改写参数，后写者生效
+    if (sendHandle != nextHandle && (cmd == VOLUME || cmd == PLAY)) {
+        const CommandHandle last = nextHandle - 1;
+        if (slot(last).frame.command() == cmd) {
+            stats.collapsedFrames++;
+            slot(last).frame = frame;
+            return last;
+        }
+    }
+    const CommandHandle oldest = inFlight != INVALID_COMMAND ? inFlight
+                               : retryHandle != INVALID_COMMAND ? retryHandle : sendHandle;
+    if (nextHandle - oldest >= QUEUE_SIZE) {
+        return INVALID_COMMAND;
+    }
+    PendingCommand& entry = slot(nextHandle);
+    entry.frame = frame;
+    entry.handle = nextHandle;
+    entry.status = CommandStatus::QUEUED;
+    entry.result = 0;
+    entry.attempts = 0;
+    entry.timeoutUs = (isQueryCommand(cmd) ? QUERY_TIMEOUT_MS : COMMAND_TIMEOUT_MS) * 1000;
+    if (nextHandle + 1 - oldest > stats.queueHighWater) {
+        stats.queueHighWater = nextHandle + 1 - oldest;
+    }
+    return nextHandle++;
+}
+
+// 与中断的连播发送互斥：在同一临界区内确认中断没有预置帧在等待应答并占用链路，
+// 之后中断看到 linkBusy 不再插入。返回 false 表示链路被中断占用，命令留待下次发送
+bool PlayerTF16P::transmit(const CommandHandle handle) {
+    critical_section_enter_blocking(&txLock);
+    if (armedPending) {
+        critical_section_exit(&txLock);
+        return false;
+    }
+    linkBusy = true;
+    critical_section_exit(&txLock);
+    PendingCommand& entry = slot(handle);
+    inFlight = handle;
+    entry.attempts++;
+    entry.status = CommandStatus::SENT;
+    entry.sentAt = time_us_64();
+    write(entry.frame.bytes, 10);
+    return true;
+}
+
+void PlayerTF16P::write(const uint8_t* data, const size_t length) {
+    critical_section_enter_blocking(&txLock);
+    stats.bytesOut += length;
+#if PLAYER_TF16P_EMULATOR
+    if (emulator) {
+        emulator->receive(data, length);
+    } else {
+        uart_write_blocking(UART_NUMBER, data, length);
+    }
+#else
+    uart_write_blocking(UART_NUMBER, data, length);
+#endif
+    critical_section_exit(&txLock);
+}
+
+#if PLAYER_TF16P_EMULATOR
+void PlayerTF16P::attach(TF16PEmulator& emulator) {
+    this->emulator = &emulator;
+    emulator.connect(receiveFromEmulator, this);
+}
+
+void PlayerTF16P::receiveFromEmulator(const uint8_t* data, const size_t length, void* arg) {
+    auto* self = static_cast<PlayerTF16P*>(arg);
+    bool delivered = false;
+    for (size_t i = 0; i < length; i++) {
+        delivered |= self->feed(data[i]);
+    }
+    if (delivered && self->notify) {
+        self->notify(self->notifyArg);
+    }
+}
+#endif
+
+PlayerTF16P* PlayerTF16P::instances[2] = {};
+
+void PlayerTF16P::uart0Irq() {
+    instances[0]->onUartIrq();
+}
+
+void PlayerTF16P::uart1Irq() {
+    instances[1]->onUartIrq();
+}
+
+bool PlayerTF16P::feed(const uint8_t byte) {
+    stats.bytesIn++;
+    if (!parser.push(byte)) {
+        return false;
+    }
+    if (sequencing && sequenceFromIsr(parser.frame())) {
+        return false;
+    }
+    if (!frames.push(parser.frame())) {
+        stats.frameOverruns++;
+        return false;
+    }
+    if (frames.size() > stats.frameQueueHighWater) {
+        stats.frameQueueHighWater = frames.size();
+    }
+    return true;
+}
+
+// 在串口中断中执行；返回 true 表示该帧是预置播放命令的应答，已被消费
+bool PlayerTF16P::sequenceFromIsr(const TF16PFrame& frame) {
+    const uint8_t cmd = frame.command();
+    const uint64_t now = time_us_64();
+    if (armedPending) {
+        if (cmd == ACK) {
+            stats.gapLatency.record(now - finishAt);
+            stats.sequencedTracks++;
+            armedPending = false;
+            return true;
+        }
+        if (cmd == ERR) {
+            armedPending = false;
+        }
+    }
+    if (cmd != FINISH_UDISK && cmd != FINISH_TFCARD && cmd != FINISH_FLASH) {
+        return false;
+    }
+    // 结束帧会重复上报，重复的一帧不能再触发切歌
+    if (frame.argument() == irqLastFinished && now - irqLastFinishedAt < FINISH_REPEAT_MS * 1000) {
+        return false;
+    }
+    irqLastFinished = frame.argument();
+    irqLastFinishedAt = now;
+    // 链路上有任务发出的命令在等待应答时不插入，交由任务按普通结束事件处理
+    critical_section_enter_blocking(&txLock);
+    if (armedTrack != 0 && !linkBusy) {
+        finishAt = now;
+        armedSentAt = now;
+        armedPending = true;
+        advancedTo = armedTrack;
+        armedTrack = 0;
+        stats.bytesOut += sizeof(armed.bytes);
+#if PLAYER_TF16P_EMULATOR
+        if (emulator) {
+            emulator->receive(armed.bytes, sizeof(armed.bytes));
+        } else {
+            uart_write_blocking(UART_NUMBER, armed.bytes, sizeof(armed.bytes));
+        }
+#else
+        uart_write_blocking(UART_NUMBER, armed.bytes, sizeof(armed.bytes));
+#endif
+    }
+    critical_section_exit(&txLock);
+    return false;
+}
+
+uint16_t PlayerTF16P::nextTrack() const {
+    if (playlistCount > 0) {
+        return playlist[playlistHead];
+    }
+    return track < cache.trackTotal[deviceIndex()].value ? track + 1 : 0;
+}
+
+void PlayerTF16P::rearm() {
+    const uint16_t next = sequencing && !looping ? nextTrack() : 0;
+    critical_section_enter_blocking(&txLock);
+    armedTrack = next;
+    if (next) {
+        armed = TF16PFrames::PLAY_TEMPLATE;
+        patchArgument(armed, next);
+    }
+    critical_section_exit(&txLock);
+}
+
+void PlayerTF16P::setSequencing(const bool enabled) {
+    sequencing = enabled;
+    rearm();
+}
+
+bool PlayerTF16P::queueNext(const uint16_t track) {
+    if (playlistCount == PLAYLIST_SIZE) {
+        return false;
+    }
+    playlist[(playlistHead + playlistCount++) % PLAYLIST_SIZE] = track;
+    rearm();
+    return true;
+}
+
+void PlayerTF16P::clearPlaylist() {
+    playlistCount = 0;
+    rearm();
+}
+
+void PlayerTF16P::onUartIrq() {
+    bool delivered = false;
+    while (uart_is_readable(UART_NUMBER)) {
+        delivered |= feed(uart_getc(UART_NUMBER));
+    }
+    if (delivered && notify) {
+        notify(notifyArg);
+    }
+}
+
+void PlayerTF16P::handleFrame(const TF16PFrame& frame) {
+    const uint8_t cmd = frame.command();
+    switch (cmd) {
+    case FINISH_UDISK:
+    case FINISH_TFCARD:
+    case FINISH_FLASH: {
+        // 模块对同一曲目会连续上报两次结束帧，只处理第一次
+        const uint64_t now = time_us_64();
+        if (frame.argument() == lastFinished && now - lastFinishedAt < FINISH_REPEAT_MS * 1000) {
+            return;
+        }
+        lastFinished = frame.argument();
+        lastFinishedAt = now;
+        const uint16_t next = advancedTo.exchange(0);
+        if (next) {
+            // 中断已发出下一曲的播放命令
+            if (playlistCount > 0 && playlist[playlistHead] == next) {
+                playlistHead = (playlistHead + 1) % PLAYLIST_SIZE;
+                playlistCount--;
+            }
+            track = next;
+            cache.currentTrack.set(next, now);
+            startPosition(armedSentAt);
+            rearm();
+            dispatch(PlayerEventType::TRACK_ADVANCED, device, next);
+            return;
+        }
+        if (looping) {
+            // 文件夹循环由模块自行续播：不停止计时也不上报结束，本地曲目号跟随模块在文件夹内前进
+            const uint8_t folder = folderIndex.folderOf(track);
+            if (folder) {
+                const uint16_t first = folderIndex.firstTrack(folder);
+                track = track + 1 < first + folderIndex.trackCount(folder) ? track + 1 : first;
+                cache.currentTrack.set(track, now);
+            } else {
+                cache.currentTrack.valid = false;
+            }
+            startPosition(now);
+            dispatch(PlayerEventType::TRACK_ADVANCED, device, track);
+            return;
+        }
+        setPlayState(false);
+        position.finish(now);
+        dispatch(PlayerEventType::TRACK_FINISHED,
+                 cmd == FINISH_UDISK ? DeviceType::UDISK : cmd == FINISH_TFCARD ? DeviceType::TFCARD : DeviceType::FLASH,
+                 frame.argument());
+        return;
+    }
+    case MEDIA_IN:
+    case MEDIA_OUT: {
+        const uint16_t mask = frame.argument();
+        const DeviceType source = mask & 0x01 ? DeviceType::UDISK : mask & 0x02 ? DeviceType::TFCARD : DeviceType::FLASH;
+        cache.invalidate();
+        folderIndex.rebuild(cache);
+        if (cmd == MEDIA_OUT && source == device) {
+            ready = false;
+            setPlayState(false);
+            position.stop();
+        }
+        dispatch(cmd == MEDIA_IN ? PlayerEventType::MEDIA_INSERTED : PlayerEventType::MEDIA_REMOVED, source, mask);
+        return;
+    }
+    case INIT:
+        // 运行中再次上线说明模块自行复位，需要重新选择设备
+        if (ready) {
+            ready = false;
+            setPlayState(false);
+            position.stop();
+            selectDevice(device);
+        }
+        return;
+    case ERR:
+        lastError = frame.argument();
+        if (inFlight != INVALID_COMMAND) {
+            complete(CommandStatus::FAILED, frame.argument());
+        }
+        dispatch(PlayerEventType::MODULE_ERROR, device, frame.argument());
+        return;
+    default:
+        break;
+    }
+    if (inFlight == INVALID_COMMAND) {
+        return;
+    }
+    const uint8_t expected = slot(inFlight).frame.command();
+    if (isQueryCommand(expected) ? cmd == expected : cmd == ACK) {
+        complete(CommandStatus::DONE, frame.argument());
+    }
+}
+
+void PlayerTF16P::dispatch(const PlayerEventType type, const DeviceType source, const uint16_t value) {
+    if (eventHandler) {
+        eventHandler(PlayerEvent{type, source, value}, eventArg);
+    }
+}
+
+// 超时无法确定模块是否已执行，只重发幂等命令；0x40 的瞬时错误表示未执行，任何命令都可重发
+bool PlayerTF16P::scheduleRetry(const CommandHandle handle, const CommandStatus status, const uint16_t result,
+                                const uint64_t now) {
+    PendingCommand& entry = slot(handle);
+    const uint8_t cmd = entry.frame.command();
+    const bool safe = status == CommandStatus::TIMEOUT ? isIdempotent(cmd) : isTransientError(result);
+    if (!safe || entry.attempts >= MAX_ATTEMPTS) {
+        // 相对命令可能已生效，需要查询模块的实际状态
+        if (status == CommandStatus::TIMEOUT && !isIdempotent(cmd)) {
+            reconcilePending = true;
+        }
+        return false;
+    }
+    // 模块在休眠：先直接发出不带应答的唤醒帧，退避后重发原命令
+    if (status == CommandStatus::FAILED && result == 0x02) {
+        asleep = false;
+        write(TF16PFrames::WAKEUP_QUIET.bytes, sizeof(TF16PFrames::WAKEUP_QUIET.bytes));
+    }
+    uint32_t backoffMs = RETRY_BASE_MS << (entry.attempts - 1);
+    if (backoffMs > RETRY_MAX_MS) {
+        backoffMs = RETRY_MAX_MS;
+    }
+    entry.status = CommandStatus::QUEUED;
+    retryHandle = handle;
+    retryAt = now + backoffMs * 1000;
+    stats.retries++;
+    return true;
+}
+
+// 让状态、当前曲目和音量的缓存失效，由空闲时的缓存刷新重新查询；设备未就绪时重新选择设备
+void PlayerTF16P::reconcile() {
+    reconcilePending = false;
+    stats.reconciliations++;
+    if (!ready) {
+        selectDevice(device);
+        return;
+    }
+    cache.status.valid = false;
+    cache.currentTrack.valid = false;
+    cache.volume.valid = false;
+}
+
+void PlayerTF16P::complete(const CommandStatus status, const uint16_t result) {
+    const CommandHandle handle = inFlight;
+    PendingCommand& entry = slot(handle);
+    inFlight = INVALID_COMMAND;
+    linkBusy = false;
+    const uint64_t now = time_us_64();
+    CacheEntry* cached = cache.entryFor(entry.frame, deviceIndex());
+    // 超时同样计入延迟直方图（记为实际等待的时间），百分位反映调用者经历的等待，而不只是收到回复的那部分
+    if (status == CommandStatus::TIMEOUT) {
+        stats.timeouts++;
+    }
+    stats.histogramFor(entry.frame.command()).record(now - entry.sentAt);
+    if (status == CommandStatus::DONE) {
+        lastError = 0;
+        if (errorStreak >= RECONCILE_AFTER) {
+            reconcilePending = true;
+        }
+        errorStreak = 0;
+    } else {
+        if (status == CommandStatus::FAILED) {
+            stats.failures++;
+        }
+        if (errorStreak < UINT8_MAX) {
+            errorStreak++;
+        }
+        if (scheduleRetry(handle, status, result, now)) {
+            return;
+        }
+    }
+    entry.status = status;
+    entry.result = result;
+    if (status != CommandStatus::DONE) {
+        // 查询失败时保留旧值并重新计时，避免空闲时反复重发
+        if (cached) {
+            cached->set(cached->value, now);
+            folderIndex.rebuild(cache);
+        }
+        return;
+    }
+    if (cached) {
+        cached->set(result, now);
+        folderIndex.rebuild(cache);
+    }
+    const uint16_t state = cache.status.value & 0xFF00;
+    switch (entry.frame.command()) {
+    case DEVICE:
+        ready = true;
+        break;
+    case PLAY:
+        cache.currentTrack.set(entry.frame.argument(), now);
+        startPosition(now);
+        setPlayState(true);
+        cache.status.set(state | 0x01, now);
+        break;
+    case RESUME:
+        position.resume(now);
+        setPlayState(true);
+        cache.status.set(state | 0x01, now);
+        break;
+    case PLAY_FOLDER:
+    case PLAY_LARGE_FOLDER:
+    case LOOP_FOLDER:
+        cache.currentTrack.set(track, now);
+        startPosition(now);
+        setPlayState(true);
+        cache.status.set(state | 0x01, now);
+        break;
+    case PAUSE:
+        position.pause(now);
+        setPlayState(false);
+        cache.status.set(state | 0x02, now);
+        break;
+    case STOP:
+        position.stop();
+        setPlayState(false);
+        cache.status.set(state, now);
+        break;
+    case STAT:
+        position.reanchor(now, (result & 0xFF) == 0x01);
+        setPlayState((result & 0xFF) == 0x01);
+        break;
+    case VOLUME:
+        cache.volume.set(entry.frame.argument(), now);
+        break;
+    case QUERY_VOLUME:
+        volume = result;
+        break;
+    case TRACK_UDISK:
+    case TRACK_TFCARD:
+    case TRACK_FLASH:
+        track = result;
+        rearm();
+        break;
+    case TOTAL_UDISK:
+    case TOTAL_TFCARD:
+    case TOTAL_FLASH:
+        rearm();
+        break;
+    default:
+        break;
+    }
+}
+
+void PlayerTF16P::refreshCache() {
+    TF16PFrame query{};
+    if (cache.nextQuery(deviceIndex(), query) <= time_us_64()) {
+        sendCommand(query);
+    }
+}
+
+// 启动阶段的探测帧直接写出，不占用命令队列
+void PlayerTF16P::probe() {
+    const uint64_t now = time_us_64();
+    if (now < probeAt) {
+        return;
+    }
+    write(TF16PFrames::STAT_FRAME.bytes, sizeof(TF16PFrames::STAT_FRAME.bytes));
+    if (probes + 1 < BOOT_PROBES) {
+        probes++;
+    }
+    probeAt = now + BOOT_PROBE_MS[probes] * 1000;
+}
+
+void PlayerTF16P::markOnline(const uint64_t now) {
+    online = true;
+    stats.onlineMs = now / 1000;
+}
+
+void PlayerTF16P::enterStandby() {
+    if (sendCommand(TF16PFrames::STANDBY_FRAME) != INVALID_COMMAND) {
+        asleep = true;
+        wokeFromStandby = true;
+        stats.standbys++;
+    }
+}
+
+void PlayerTF16P::wake() {
+    asleep = false;
+    sendCommand(TF16PFrames::WAKEUP_FRAME);
+}
+
+CommandHandle PlayerTF16P::prewarm() {
+    lastActivityAt = time_us_64();
+    if (!asleep) {
+        return INVALID_COMMAND;
+    }
+    asleep = false;
+    return sendCommand(TF16PFrames::WAKEUP_FRAME);
+}
+
+void PlayerTF16P::publishState() {
+    state.publish(PlayerState{track, volume, playing, ready, device, lastError, position});
+}
+
+void PlayerTF16P::startPosition(const uint64_t at) {
+    position.start(at, durationSource ? durationSource(device, track, durationArg) : 0);
+}
+
+void PlayerTF16P::process() {
+    TF16PFrame frame{};
+    while (frames.pop(frame)) {
+        // 上电中的模块可能回复忙错误，不能据此判定上线
+        if (!online && frame.command() != ERR) {
+            markOnline(time_us_64());
+        }
+        handleFrame(frame);
+    }
+    if (!online) {
+        probe();
+        publishState();
+        return;
+    }
+    if (inFlight != INVALID_COMMAND) {
+        const PendingCommand& entry = slot(inFlight);
+        if (time_us_64() - entry.sentAt > entry.timeoutUs) {
+            complete(CommandStatus::TIMEOUT, 0);
+        }
+    }
+    // 错误突发结束后重新同步，再在链路空闲时补齐或刷新缓存的查询结果
+    if (reconcilePending && isIdle()) {
+        reconcile();
+    }
+    // 待机期间不刷新缓存，以免查询把模块唤醒
+    if (ready && isIdle() && !asleep) {
+        if (standbyMs && !playing && time_us_64() - lastActivityAt >= static_cast<uint64_t>(standbyMs) * 1000) {
+            enterStandby();
+        } else {
+            refreshCache();
+        }
+    }
+    // 中断发出的连播命令等待应答期间暂停发送，超时后放弃等待
+    if (armedPending && time_us_64() - armedSentAt > COMMAND_TIMEOUT_MS * 1000) {
+        armedPending = false;
+    }
+    // 上一帧完成后立即发送下一帧，不再固定等待；退避中的重发命令优先
+    if (inFlight == INVALID_COMMAND) {
+        if (retryHandle != INVALID_COMMAND) {
+            if (time_us_64() >= retryAt && transmit(retryHandle)) {
+                retryHandle = INVALID_COMMAND;
+            }
+        } else if (sendHandle != nextHandle && transmit(sendHandle)) {
+            sendHandle++;
+        }
+    }
+    publishState();
+}
+
+uint32_t PlayerTF16P::msUntilDeadline() const {
+    if (!online) {
+        const uint64_t now = time_us_64();
+        return probeAt <= now ? 0 : (probeAt - now + 999) / 1000;
+    }
+    if (inFlight == INVALID_COMMAND) {
+        // 中断发出的连播命令等待应答期间不发送，应答到达时由中断唤醒，否则等到应答超时
+        if (armedPending) {
+            const uint64_t elapsed = time_us_64() - armedSentAt;
+            const uint64_t timeoutUs = COMMAND_TIMEOUT_MS * 1000;
+            return elapsed >= timeoutUs ? 0 : (timeoutUs - elapsed + 999) / 1000;
+        }
+        if (retryHandle != INVALID_COMMAND) {
+            const uint64_t now = time_us_64();
+            return retryAt <= now ? 0 : (retryAt - now + 999) / 1000;
+        }
+        if (sendHandle != nextHandle) {
+            return 0;
+        }
+        if (!ready || asleep) {
+            return UINT32_MAX;
+        }
+        TF16PFrame query{};
+        uint64_t refreshAt = cache.nextQuery(deviceIndex(), query);
+        if (standbyMs && !playing) {
+            const uint64_t standbyAt = lastActivityAt + static_cast<uint64_t>(standbyMs) * 1000;
+            if (standbyAt < refreshAt) {
+                refreshAt = standbyAt;
+            }
+        }
+        if (refreshAt == UINT64_MAX) {
+            return UINT32_MAX;
+        }
+        const uint64_t now = time_us_64();
+        return refreshAt <= now ? 0 : (refreshAt - now + 999) / 1000;
+    }
+    const PendingCommand& entry = slot(inFlight);
+    const uint64_t elapsed = time_us_64() - entry.sentAt;
+    if (elapsed >= entry.timeoutUs) {
+        return 0;
+    }
+    return (entry.timeoutUs - elapsed + 999) / 1000;
+}
+
+PlayerStats PlayerTF16P::snapshot() const {
+    PlayerStats copy = stats;
+    copy.checksumErrors = parser.getChecksumErrors();
+    copy.discardedBytes = parser.getDiscardedBytes();
+    return copy;
+}
+
+CommandStatus PlayerTF16P::status(const CommandHandle handle) const {
+    if (handle == INVALID_COMMAND || slot(handle).handle != handle) {
+        return CommandStatus::EXPIRED;
+    }
+    return slot(handle).status;
+}
+
+uint16_t PlayerTF16P::result(const CommandHandle handle) const {
+    if (status(handle) != CommandStatus::DONE) {
+        return 0;
+    }
+    return slot(handle).result;
+}
+
+CommandHandle PlayerTF16P::begin(const DeviceType type) {
+    critical_section_init(&txLock);
+    // 不再固定等待模块上电：设备选择先入队，由 process() 在模块上线后发出
+    online = false;
+    probes = 0;
+    probeAt = time_us_64() + BOOT_PROBE_MS[0] * 1000;
+#if PLAYER_TF16P_EMULATOR
+    if (emulator) {
+        return selectDevice(type);
+    }
+#endif
+    uart_init(UART_NUMBER, 9600);
+    gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
+    gpio_set_function(UART_RX_PIN, GPIO_FUNC_UART);
+    const uint index = uart_get_index(UART_NUMBER);
+    const uint irq = index ? UART1_IRQ : UART0_IRQ;
+    instances[index] = this;
+    irq_set_exclusive_handler(irq, index ? uart1Irq : uart0Irq);
+    irq_set_enabled(irq, true);
+    uart_set_irq_enables(UART_NUMBER, true, false);
+    return selectDevice(type);
+}
+
+CommandHandle PlayerTF16P::selectDevice(const DeviceType type) {
+    device = type;
+    cache.invalidate();
+    folderIndex.rebuild(cache);
+    switch (type) {
+    case DeviceType::UDISK:
+        return sendCommand(TF16PFrames::SELECT_UDISK);
+    case DeviceType::TFCARD:
+        return sendCommand(TF16PFrames::SELECT_TFCARD);
+    default:
+        return sendCommand(TF16PFrames::SELECT_FLASH);
+    }
+}
+
+CommandHandle PlayerTF16P::setVolume(uint8_t volume) {
+    if (volume > 30) {
+        volume = 30;
+    }
+    this->volume = volume;
+    TF16PFrame frame = TF16PFrames::VOLUME_TEMPLATE;
+    patchArgument(frame, volume);
+    return sendCommand(frame);
+}
+
+CommandHandle PlayerTF16P::playTrack(const uint16_t track) {
+    this->track = track;
+    // 手动切歌后，预置的下一曲改为新曲目之后的一首
+    looping = false;
+    playlistCount = 0;
+    rearm();
+    TF16PFrame frame = TF16PFrames::PLAY_TEMPLATE;
+    patchArgument(frame, track);
+    return sendCommand(frame);
+}
+
+CommandHandle PlayerTF16P::playNext() {
+    const uint16_t next = nextTrack();
+    if (next == 0) {
+        return INVALID_COMMAND;
+    }
+    if (playlistCount > 0) {
+        playlistHead = (playlistHead + 1) % PLAYLIST_SIZE;
+        playlistCount--;
+    }
+    track = next;
+    looping = false;
+    rearm();
+    TF16PFrame frame = TF16PFrames::PLAY_TEMPLATE;
+    patchArgument(frame, next);
+    return sendCommand(frame);
+}
+
+CommandHandle PlayerTF16P::playFolderTrack(const uint8_t folder, const uint16_t file) {
+    TF16PFrame frame{};
+    if (folder >= 1 && folder <= 99 && file >= 1 && file <= 255) {
+        frame = makeFrame(PLAY_FOLDER, folder << 8 | file);
+    } else if (folder >= 1 && folder <= 15 && file >= 1 && file <= 3000) {
+        frame = makeFrame(PLAY_LARGE_FOLDER, folder << 12 | file);
+    } else {
+        return INVALID_COMMAND;
+    }
+    const uint16_t global = folderIndex.globalIndex(folder, file);
+    if (global) {
+        track = global;
+    }
+    looping = false;
+    playlistCount = 0;
+    rearm();
+    return sendCommand(frame);
+}
+
+CommandHandle PlayerTF16P::loopFolder(const uint8_t folder) {
+    if (folder < 1 || folder > 99) {
+        return INVALID_COMMAND;
+    }
+    if (folderIndex.firstTrack(folder)) {
+        track = folderIndex.firstTrack(folder);
+    }
+    looping = true;
+    playlistCount = 0;
+    rearm();
+    return sendCommand(makeFrame(LOOP_FOLDER, folder));
+}
+
+CommandHandle PlayerTF16P::playNextFolder() {
+    const uint8_t folders = folderIndex.getFolders();
+    uint8_t folder = folderIndex.folderOf(track);
+    if (folder == 0) {
+        return INVALID_COMMAND;
+    }
+    // 跳过空文件夹，到末尾后回到第一个
+    for (uint8_t i = 0; i < folders; i++) {
+        folder = folder < folders ? folder + 1 : 1;
+        if (folderIndex.trackCount(folder)) {
+            return playFolderTrack(folder, 1);
+        }
+    }
+    return INVALID_COMMAND;
+}
+
+CommandHandle PlayerTF16P::playPreviousFolder() {
+    const uint8_t folders = folderIndex.getFolders();
+    uint8_t folder = folderIndex.folderOf(track);
+    if (folder == 0) {
+        return INVALID_COMMAND;
+    }
+    for (uint8_t i = 0; i < folders; i++) {
+        folder = folder > 1 ? folder - 1 : folders;
+        if (folderIndex.trackCount(folder)) {
+            return playFolderTrack(folder, 1);
+        }
+    }
+    return INVALID_COMMAND;
+}
+
+CommandHandle PlayerTF16P::stop() {
+    return sendCommand(TF16PFrames::STOP_FRAME);
+}
+
+CommandHandle PlayerTF16P::pause() {
+    return sendCommand(TF16PFrames::PAUSE_FRAME);
+}
+
+CommandHandle PlayerTF16P::resume() {
+    return sendCommand(TF16PFrames::RESUME_FRAME);
+}
+
+CommandHandle PlayerTF16P::getStats() {
+    return sendCommand(TF16PFrames::STAT_FRAME);
+}
+
+CommandHandle PlayerTF16P::queryTrackTotal() {
+    return sendCommand(makeFrame(TOTAL_UDISK + deviceIndex()));
+}
@@ -2,17 +2,14 @@
 #define PLAYER_TF16P_H
 #include "pico/stdlib.h"
 #include "hardware/uart.h"
-#define VOLUME 0x06
-#define PLAY 0x03
-#define RESET 0x0C
-#define NEXT 0x01
-#define PREVIOUS 0x02
-#define PAUSE 0x0E
-#define RESUME 0x0D
-#define STOP 0x16
-#define STAT 0x42
-#define DEVICE 0x09
-#define INIT 0x3F
+#include "pico/critical_section.h"
+#include "SpscRing.h"
+#include "TF16PParser.h"
+#include "PlayerStats.h"
+#include "QueryCache.h"
+#include "FolderIndex.h"
+#include "StateLatch.h"
+#include "PositionTracker.h"
 
 enum class DeviceType {
     UDISK, TFCARD, FLASH
@@ -22,48 +19,214 @@ enum class ErrorType {
     NO_DEVICE, CHECKSUM_ERR, OUTBOUND, NOTFOUND
 };
 
+// 异步命令的完成状态
+enum class CommandStatus : uint8_t {
+    QUEUED, // 已入队，等待发送
+    SENT, // 已发送，等待模块应答
+    DONE, // 收到0x41应答或查询结果
+    FAILED, // 模块返回0x40错误帧
+    TIMEOUT, // 超时未应答
+    EXPIRED // 句柄无效或所在槽位已被新命令复用
+};
+
+// 模块主动上报的事件
+enum class PlayerEventType : uint8_t {
+    TRACK_FINISHED, // 0x3C/0x3D/0x3E，value 为结束的曲目号
+    TRACK_ADVANCED, // 连播模式下已在中断中切到下一曲，或文件夹循环时模块自行续播，value 为新曲目号
+    MEDIA_INSERTED, // 0x3A
+    MEDIA_REMOVED, // 0x3B
+    MODULE_ERROR // 0x40，value 为错误码
+};
+
+struct PlayerEvent {
+    PlayerEventType type;
+    DeviceType device;
+    uint16_t value;
+};
+
+// 播放器状态快照，由播放器任务在 process() 末尾发布，其他任务或中断无锁读取
+struct PlayerState {
+    uint16_t track;
+    uint16_t volume;
+    bool playing;
+    bool ready;
+    DeviceType device;
+    uint16_t error; // 最近一次0x40错误码，之后有命令成功时清零
+    // 播放位置锚点，读者用 position.positionMs(time_us_64()) 推算当前位置，无需等待新快照
+    PositionTracker position;
+};
+
+class TF16PEmulator;
+
+using CommandHandle = uint32_t;
+constexpr CommandHandle INVALID_COMMAND = 0;
 
 class PlayerTF16P {
-    uint8_t command[10];
-    uint8_t received[10]{};
+public:
+    static constexpr uint8_t QUEUE_SIZE = 16;
+    static constexpr uint32_t COMMAND_TIMEOUT_MS = 200;
+    static constexpr uint32_t QUERY_TIMEOUT_MS = 500;
+    static constexpr uint16_t FRAME_QUEUE_SIZE = 8;
+    static constexpr uint8_t PLAYLIST_SIZE = 8;
+    static constexpr uint32_t FINISH_REPEAT_MS = 1000;
+    // 重发：每条命令最多发送 MAX_ATTEMPTS 次，间隔从 RETRY_BASE_MS 起倍增，不超过 RETRY_MAX_MS
+    static constexpr uint8_t MAX_ATTEMPTS = 4;
+    static constexpr uint32_t RETRY_BASE_MS = 20;
+    static constexpr uint32_t RETRY_MAX_MS = 320;
+    // 连续失败达到该次数视为错误突发，链路恢复后重新查询状态、音量和曲目
+    static constexpr uint8_t RECONCILE_AFTER = 3;
+    // 上电检测：收到0x3F上线帧或任意非错误回复前不发送命令，期间按逐步放宽的间隔发送状态查询探测
+    static constexpr uint16_t BOOT_PROBE_MS[] = {200, 300, 500, 800, 1200};
+    static constexpr uint8_t BOOT_PROBES = sizeof(BOOT_PROBE_MS) / sizeof(BOOT_PROBE_MS[0]);
+    // 待机：停止或暂停且链路空闲超过设定时间后让模块休眠，下一条命令前自动唤醒
+    static constexpr uint32_t STANDBY_IDLE_MS = 120000;
+    using NotifyCallback = void (*)(void* arg);
+    using EventCallback = void (*)(const PlayerEvent& event, void* arg);
+    // 曲目时长来源（文件头解析、预建索引等），未知时返回0
+    using DurationSource = uint32_t (*)(DeviceType device, uint16_t track, void* arg);
+
+private:
+    struct PendingCommand {
+        TF16PFrame frame;
+        CommandHandle handle;
+        CommandStatus status;
+        uint16_t result;
+        uint32_t timeoutUs;
+        uint64_t sentAt;
+        uint8_t attempts;
+    };
+
+    // 句柄按序分配，槽位为 handle % QUEUE_SIZE；[sendHandle, nextHandle) 为待发送区间
+    PendingCommand queue[QUEUE_SIZE]{};
+    CommandHandle nextHandle = 1;
+    CommandHandle sendHandle = 1;
+    CommandHandle inFlight = INVALID_COMMAND;
+    // 等待退避后重发的命令，先于待发送区间发出
+    CommandHandle retryHandle = INVALID_COMMAND;
+    uint64_t retryAt = 0;
+    uint8_t errorStreak = 0;
+    bool reconcilePending = false;
+    // 串口中断中完成解析，完整帧经无锁队列交给 process()
+    TF16PParser parser;
+    SpscRing<TF16PFrame, FRAME_QUEUE_SIZE> frames;
+    PlayerStats stats;
+    NotifyCallback notify = nullptr;
+    void* notifyArg = nullptr;
+    EventCallback eventHandler = nullptr;
+    void* eventArg = nullptr;
+#if PLAYER_TF16P_EMULATOR
+    TF16PEmulator* emulator = nullptr;
+#endif
     uint8_t UART_TX_PIN;
     uint8_t UART_RX_PIN;
     uart_inst_t* UART_NUMBER;
     DeviceType device;
     uint16_t track;
     uint16_t volume;
+    QueryCache cache;
+    FolderIndex folderIndex;
+    bool online = false;
+    uint8_t probes = 0;
+    uint64_t probeAt = 0;
     bool ready{};
     bool playing{};
+    uint16_t lastError = 0;
+    PositionTracker position;
+    DurationSource durationSource = nullptr;
+    void* durationArg = nullptr;
+    StateLatch<PlayerState> state;
+    // 待机状态：asleep 在休眠帧入队时置位、唤醒帧入队时清除；resumeAt 为待机后首个播放命令的入队时间
+    uint32_t standbyMs = 0;
+    uint64_t lastActivityAt = 0;
+    bool asleep = false;
+    bool wokeFromStandby = false;
+    uint64_t resumeAt = 0;
+    uint16_t lastFinished = 0;
+    uint64_t lastFinishedAt = 0;
 
-    void sendCommand() {
-        command[0] = 0x7E;
-        command[1] = 0xFF;
-        command[2] = 0x06;
-        uint16_t checksum = 0;
-        for (int i = 1; i < 7; i++) {
-            checksum += command[i];
-        }
-        checksum = ~checksum + 1;
-        const uint8_t lowByte = checksum & 0x00FF;
-        const uint8_t highByte = (checksum & 0xFF00) >> 8;
-        command[7] = highByte;
-        command[8] = lowByte;
-        command[9] = 0xEF;
-        uart_write_blocking(uart1, command, 10);
-        sleep_ms(200);
+    // 连播：任务侧维护待播列表并预置下一曲的播放帧，结束帧到达时由串口中断直接发出
+    critical_section_t txLock{};
+    bool sequencing = false;
+    bool looping = false; // 0x17 文件夹循环由模块自行续播，此时不预置下一曲
+    uint16_t playlist[PLAYLIST_SIZE]{};
+    uint8_t playlistHead = 0;
+    uint8_t playlistCount = 0;
+    TF16PFrame armed{};
+    uint16_t armedTrack = 0;
+    // 以下由串口中断与任务共享
+    std::atomic<bool> linkBusy{false};
+    std::atomic<bool> armedPending{false};
+    std::atomic<uint16_t> advancedTo{0};
+    uint64_t armedSentAt = 0;
+    uint64_t finishAt = 0;
+    uint16_t irqLastFinished = 0;
+    uint64_t irqLastFinishedAt = 0;
+
+    PendingCommand& slot(const CommandHandle handle) {
+        return queue[handle % QUEUE_SIZE];
+    }
+
+    [[nodiscard]] const PendingCommand& slot(const CommandHandle handle) const {
+        return queue[handle % QUEUE_SIZE];
     }
 
+    CommandHandle sendCommand(const TF16PFrame& frame);
+    bool transmit(CommandHandle handle);
+    bool scheduleRetry(CommandHandle handle, CommandStatus status, uint16_t result, uint64_t now);
+    void reconcile();
+    void write(const uint8_t* data, size_t length);
+    bool feed(uint8_t byte);
+    bool sequenceFromIsr(const TF16PFrame& frame);
+    // 连播的下一曲：待播列表的第一首，列表为空时为当前曲目+1，已是最后一首时为0
+    [[nodiscard]] uint16_t nextTrack() const;
+    void rearm();
+    void onUartIrq();
+    void handleFrame(const TF16PFrame& frame);
+    void complete(CommandStatus status, uint16_t result);
+    void dispatch(PlayerEventType type, DeviceType source, uint16_t value);
+
+    [[nodiscard]] uint8_t deviceIndex() const {
+        return static_cast<uint8_t>(device);
+    }
+
+    void refreshCache();
+    void probe();
+    void markOnline(uint64_t now);
+    void enterStandby();
+    void publishState();
+    void startPosition(uint64_t at);
+    void wake();
+
     void setPlayState(const bool play) {
+        if (play && stats.firstAudioMs == 0) {
+            stats.firstAudioMs = time_us_64() / 1000;
+        }
+        if (play && resumeAt) {
+            stats.resumeLatency.record(time_us_64() - resumeAt);
+            resumeAt = 0;
+        }
         playing = play;
     }
 
+    static PlayerTF16P* instances[2];
+    static void uart0Irq();
+    static void uart1Irq();
+#if PLAYER_TF16P_EMULATOR
+    static void receiveFromEmulator(const uint8_t* data, size_t length, void* arg);
+#endif
+
 public:
     PlayerTF16P(const uint8_t txPin, const uint8_t rxPin, uart_inst_t* uart)
-        : command(), UART_TX_PIN(txPin), UART_RX_PIN(rxPin), UART_NUMBER(uart), device(), track(1), volume(10) {
+        : UART_TX_PIN(txPin), UART_RX_PIN(rxPin), UART_NUMBER(uart), device(), track(1), volume(10) {
     }
 
     ~PlayerTF16P() = default;
 
+    // 模块已上线（收到上线帧或探测回复），之前入队的命令暂不发送
+    [[nodiscard]] bool isOnline() const {
+        return online;
+    }
+
     [[nodiscard]] bool isReady() const {
         return ready;
     }
@@ -72,108 +235,107 @@ public:
         return playing;
     }
 
-    void begin(const DeviceType type) {
-        sleep_ms(2000);
-        uart_init(UART_NUMBER, 9600);
-        gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
-        gpio_set_function(UART_RX_PIN, GPIO_FUNC_UART);
-        command[3] = DEVICE;
-        command[4] = 0x00;
-        command[5] = 0x01;
-        switch (type) {
-        case DeviceType::UDISK:
-            command[6] = 0x01;
-            break;
-        case DeviceType::TFCARD:
-            command[6] = 0x02;
-            break;
-        case DeviceType::FLASH:
-            command[6] = 0x04;
-            break;
-        }
-        sendCommand();
-        uart_read_blocking(UART_NUMBER, received, 10);
-        if (received[3] == 0x40) {
-            //TODO Error Processing
-            return;
-        }
-        ready = true;
+    // 0x17 文件夹循环中：曲目结束由模块自行续播，不产生 TRACK_FINISHED
+    [[nodiscard]] bool isLooping() const {
+        return looping;
     }
 
-    void setVolume(uint8_t volume) {
-        if (volume > 30) {
-            volume = 30;
-        }
-        if (volume < 0) {
-            volume = 0;
-        }
-        this->volume = volume;
-        command[3] = VOLUME;
-        command[4] = 0x00;
-        command[5] = 0x00;
-        command[6] = volume;
-        sendCommand();
-    }
-
-    void playTrack(const uint16_t track) {
-        command[3] = PLAY;
-        command[4] = 0x00;
-        command[5] = (track & 0xFF00) >> 8;
-        command[6] = track & 0x00FF;
-        this->track = track;
-        sendCommand();
-        playing = true;
-    }
-
-    void stop() {
-        command[3] = STOP;
-        command[4] = 0x00;
-        command[5] = 0x00;
-        command[6] = 0x00;
-        sendCommand();
-    }
-
-    void pause() {
-        command[3] = PAUSE;
-        command[4] = 0x00;
-        command[5] = 0x00;
-        command[6] = 0x00;
-        sendCommand();
-    }
-
-    void resume() {
-        command[3] = RESUME;
-        command[4] = 0x00;
-        command[5] = 0x00;
-        command[6] = 0x00;
-        sendCommand();
-    }
-
-    void getStats() {
-        command[3] = STAT;
-        command[4] = 0x00;
-        command[5] = 0x00;
-        command[6] = 0x00;
-        sendCommand();
-    }
-
-    uint16_t getTrackTotal() {
-        switch (device) {
-        case DeviceType::UDISK:
-            command[3] = 0x47;
-            break;
-        case DeviceType::TFCARD:
-            command[3] = 0x48;
-            break;
-        default:
-            return 0;
-        }
-        command[4] = 0x01;
-        command[5] = 0x00;
-        command[6] = 0x00;
-        sendCommand();
-        uart_read_blocking(UART_NUMBER, received, 10);
-        return received[5] << 2 + received[6];
+    void setDurationSource(const DurationSource source, void* arg) {
+        durationArg = arg;
+        durationSource = source;
+    }
+
+    // 当前播放位置的本地估计，不产生串口通信
+    [[nodiscard]] uint32_t getPositionMs() const {
+        return position.positionMs(time_us_64());
+    }
+
+    // 无锁读取最近发布的状态，不需要持有播放区的互斥锁
+    [[nodiscard]] PlayerState readState() const {
+        return state.read();
+    }
+
+    [[nodiscard]] bool isAsleep() const {
+        return asleep;
+    }
+
+    // 空闲多久后进入待机，0 表示不待机
+    void setStandby(const uint32_t idleMs) {
+        standbyMs = idleMs;
+    }
+
+    // 用户开始操作界面时调用：模块在待机则提前唤醒，并重新开始计算空闲时间
+    CommandHandle prewarm();
+
+#if PLAYER_TF16P_EMULATOR
+    // 用进程内模拟器代替串口，需在 begin() 之前调用
+    void attach(TF16PEmulator& emulator);
+#endif
+
+    // begin() 不等待模块上电，设备选择命令在模块上线后自动发出。
+    // 以下命令均立即返回，完成情况通过 status()/result() 查询，收发由 process() 推进。
+    // 超时或模块报忙/校验错时自动退避重发，重发期间状态为 QUEUED；相对命令超时不重发
+    CommandHandle begin(DeviceType type);
+    CommandHandle selectDevice(DeviceType type);
+    CommandHandle setVolume(uint8_t volume);
+    CommandHandle playTrack(uint16_t track);
+    // 按文件夹播放：文件号不超过255用0x0F，否则用0x14（文件夹1~15，文件号至3000）
+    CommandHandle playFolderTrack(uint8_t folder, uint16_t file);
+    CommandHandle loopFolder(uint8_t folder);
+    // 播放连播顺序中的下一曲（与中断预置的选择相同，并从待播列表中取出），已是最后一首时返回 INVALID_COMMAND
+    CommandHandle playNext();
+    CommandHandle playNextFolder();
+    CommandHandle playPreviousFolder();
+    CommandHandle stop();
+    CommandHandle pause();
+    CommandHandle resume();
+    CommandHandle getStats();
+    CommandHandle queryTrackTotal();
+
+    void process();
+
+    // 中断收到完整帧后调用，用于唤醒等待中的任务（在中断上下文中执行）
+    void setNotify(const NotifyCallback callback, void* arg) {
+        notifyArg = arg;
+        notify = callback;
+    }
+
+    // 连播模式：曲目结束时在串口中断中立即发送下一曲，省去任务调度与排队的间隙。
+    // 下一曲取自待播列表，列表为空时为当前曲目+1
+    void setSequencing(bool enabled);
+
+    bool queueNext(uint16_t track);
+
+    void clearPlaylist();
+
+    // 模块主动上报的帧在 process() 中转换为事件回调（在调用 process() 的任务中执行）
+    void setEventHandler(const EventCallback callback, void* arg) {
+        eventArg = arg;
+        eventHandler = callback;
+    }
+
+    // 距离在途命令超时的毫秒数；有待发送命令时为0，完全空闲时为 UINT32_MAX；
+    // 模块上线前为下一次探测的时间，等待待机时为进入待机的时间，连播命令等待应答时为其超时时间
+    [[nodiscard]] uint32_t msUntilDeadline() const;
+
+    [[nodiscard]] CommandStatus status(CommandHandle handle) const;
+
+    [[nodiscard]] uint16_t result(CommandHandle handle) const;
+
+    [[nodiscard]] bool isIdle() const {
+        return inFlight == INVALID_COMMAND && retryHandle == INVALID_COMMAND && sendHandle == nextHandle;
+    }
+
+    // 队列中被后续同类命令改写而省去的帧数
+    [[nodiscard]] uint32_t getCollapsedFrames() const {
+        return stats.collapsedFrames;
+    }
+
+    // 链路统计快照，可在其他任务中调用；各计数器不保证取自同一时刻
+    [[nodiscard]] PlayerStats snapshot() const;
+
+    void dumpStats() const {
+        snapshot().print();
     }
 
     [[nodiscard]] uint16_t getVolume() const {
@@ -183,6 +345,36 @@ public:
     [[nodiscard]] uint16_t getTrack() const {
         return track;
     }
+
+    // 以下查询结果取自缓存，不产生串口通信；读取过的值过期后由 process() 在链路空闲时刷新
+    [[nodiscard]] uint16_t getTrackTotal() const {
+        return cache.trackTotal[deviceIndex()].get();
+    }
+
+    [[nodiscard]] uint16_t getFolderTotal() const {
+        return cache.folderTotal.get();
+    }
+
+    [[nodiscard]] uint16_t getFolderFiles(const uint8_t folder) const {
+        if (folder < 1 || folder > QueryCache::MAX_FOLDERS) {
+            return 0;
+        }
+        return cache.folderFiles[folder - 1].get();
+    }
+
+    // 启动时由缓存的文件夹文件数建立，全部文件夹数据就绪前 isValid() 为 false
+    [[nodiscard]] const FolderIndex& getFolderIndex() const {
+        return folderIndex;
+    }
+
+    [[nodiscard]] uint8_t getFolder() const {
+        return folderIndex.folderOf(track);
+    }
+
+    // 0x42 状态回复：高字节为设备，低字节 0 停止 / 1 播放 / 2 暂停
+    [[nodiscard]] uint16_t getModuleStatus() const {
+        return cache.status.get();
+    }
 };
 
 #endif // PLAYER_TF16P_H
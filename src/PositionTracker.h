@@ -0,0 +1,82 @@
+#ifndef POSITION_TRACKER_H
+#define POSITION_TRACKER_H
+#include <stdint.h>
+
+// 播放位置估计：记录锚点（时刻与当时的位置），之后按本地时钟推算，不向模块查询。
+// 播放/继续时开始计时，暂停时冻结，曲目结束和状态回复时重新定锚。可平凡复制，随状态快照发布
+class PositionTracker {
+    uint64_t anchorAt = 0; // time_us_64
+    uint32_t anchorMs = 0;
+    uint32_t durationMs = 0; // 0 表示时长未知
+    bool running = false;
+
+public:
+    // 新曲目从头开始播放
+    void start(const uint64_t now, const uint32_t duration) {
+        anchorAt = now;
+        anchorMs = 0;
+        durationMs = duration;
+        running = true;
+    }
+
+    void resume(const uint64_t now) {
+        if (!running) {
+            anchorAt = now;
+            running = true;
+        }
+    }
+
+    void pause(const uint64_t now) {
+        if (running) {
+            anchorMs = positionMs(now);
+            anchorAt = now;
+            running = false;
+        }
+    }
+
+    void stop() {
+        anchorMs = 0;
+        running = false;
+    }
+
+    // 曲目结束：位置停在末尾；时长未知时用推算值修正时长
+    void finish(const uint64_t now) {
+        const uint32_t at = positionMs(now);
+        if (durationMs == 0) {
+            durationMs = at;
+        }
+        anchorMs = durationMs;
+        running = false;
+    }
+
+    // 状态回复中的播放/暂停与本地推算不一致时，以模块为准
+    void reanchor(const uint64_t now, const bool playing) {
+        if (playing) {
+            resume(now);
+        } else {
+            pause(now);
+        }
+    }
+
+    [[nodiscard]] uint32_t positionMs(const uint64_t now) const {
+        if (!running) {
+            return anchorMs;
+        }
+        const uint32_t at = anchorMs + static_cast<uint32_t>((now - anchorAt) / 1000);
+        return durationMs && at > durationMs ? durationMs : at;
+    }
+
+    [[nodiscard]] uint32_t remainingMs(const uint64_t now) const {
+        return durationMs ? durationMs - positionMs(now) : 0;
+    }
+
+    [[nodiscard]] uint32_t getDurationMs() const {
+        return durationMs;
+    }
+
+    [[nodiscard]] bool isRunning() const {
+        return running;
+    }
+};
+
+#endif // POSITION_TRACKER_H
@@ -0,0 +1,125 @@
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+#include <stdint.h>
+#include "TF16PFrame.h"
+
+// 单个查询结果：无效时尽快补齐；有效但过期的值只有被读取过才会刷新
+struct CacheEntry {
+    uint16_t value = 0;
+    uint64_t updatedAt = 0;
+    uint32_t ttlUs = 0;
+    bool valid = false;
+    mutable bool wanted = false;
+
+    void set(const uint16_t newValue, const uint64_t now) {
+        value = newValue;
+        updatedAt = now;
+        valid = true;
+        wanted = false;
+    }
+
+    [[nodiscard]] uint16_t get() const {
+        wanted = true;
+        return value;
+    }
+
+    [[nodiscard]] uint64_t refreshAt() const {
+        if (!valid) {
+            return 0;
+        }
+        return wanted ? updatedAt + ttlUs : UINT64_MAX;
+    }
+};
+
+// 模块查询结果缓存：各设备曲目总数、文件夹数与各文件夹文件数、播放状态、当前曲目和音量
+class QueryCache {
+public:
+    static constexpr uint8_t DEVICES = 3;
+    static constexpr uint8_t MAX_FOLDERS = 99;
+    static constexpr uint32_t TOTAL_TTL_MS = 60000;
+    static constexpr uint32_t STATUS_TTL_MS = 5000;
+
+    CacheEntry trackTotal[DEVICES];
+    CacheEntry folderTotal;
+    CacheEntry folderFiles[MAX_FOLDERS];
+    CacheEntry status;
+    CacheEntry currentTrack;
+    CacheEntry volume;
+
+    QueryCache() {
+        for (CacheEntry& entry : trackTotal) {
+            entry.ttlUs = TOTAL_TTL_MS * 1000;
+        }
+        for (CacheEntry& entry : folderFiles) {
+            entry.ttlUs = TOTAL_TTL_MS * 1000;
+        }
+        folderTotal.ttlUs = TOTAL_TTL_MS * 1000;
+        status.ttlUs = STATUS_TTL_MS * 1000;
+        currentTrack.ttlUs = STATUS_TTL_MS * 1000;
+        volume.ttlUs = STATUS_TTL_MS * 1000;
+    }
+
+    void invalidate() {
+        for (CacheEntry& entry : trackTotal) {
+            entry.valid = false;
+        }
+        for (CacheEntry& entry : folderFiles) {
+            entry.valid = false;
+        }
+        folderTotal.valid = false;
+        status.valid = false;
+        currentTrack.valid = false;
+        volume.valid = false;
+    }
+
+    // 查询帧对应的缓存项，非缓存类查询返回 nullptr
+    CacheEntry* entryFor(const TF16PFrame& query, const uint8_t device) {
+        const uint8_t cmd = query.command();
+        if (cmd >= TOTAL_UDISK && cmd <= TOTAL_FLASH) {
+            return &trackTotal[cmd - TOTAL_UDISK];
+        }
+        if (cmd >= TRACK_UDISK && cmd <= TRACK_FLASH) {
+            return cmd - TRACK_UDISK == device ? &currentTrack : nullptr;
+        }
+        switch (cmd) {
+        case STAT:
+            return &status;
+        case QUERY_VOLUME:
+            return &volume;
+        case FOLDER_TOTAL:
+            return &folderTotal;
+        case FOLDER_FILES: {
+            const uint16_t folder = query.argument();
+            return folder >= 1 && folder <= MAX_FOLDERS ? &folderFiles[folder - 1] : nullptr;
+        }
+        default:
+            return nullptr;
+        }
+    }
+
+    // 返回最早需要刷新的时间（time_us_64），无需刷新时为 UINT64_MAX；frame 为对应的查询帧
+    uint64_t nextQuery(const uint8_t device, TF16PFrame& frame) const {
+        uint64_t earliest = UINT64_MAX;
+        const auto consider = [&](const CacheEntry& entry, const TF16PFrame& query) {
+            const uint64_t at = entry.refreshAt();
+            if (at < earliest) {
+                earliest = at;
+                frame = query;
+            }
+        };
+        consider(trackTotal[device], makeFrame(TOTAL_UDISK + device));
+        consider(status, TF16PFrames::STAT_FRAME);
+        consider(currentTrack, makeFrame(TRACK_UDISK + device));
+        consider(volume, makeFrame(QUERY_VOLUME));
+        consider(folderTotal, makeFrame(FOLDER_TOTAL));
+        if (folderTotal.valid) {
+            const uint16_t folders = folderTotal.value < MAX_FOLDERS ? folderTotal.value : MAX_FOLDERS;
+            for (uint16_t i = 0; i < folders && earliest != 0; i++) {
+                consider(folderFiles[i], makeFrame(FOLDER_FILES, i + 1));
+            }
+        }
+        return earliest;
+    }
+};
+
+#endif // QUERY_CACHE_H
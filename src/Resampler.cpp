@@ -0,0 +1,169 @@
+#include "Resampler.h"
+#include <string.h>
+#include "PackedMath.h"
+
+// 编译期数学函数，只用于生成系数表
+static constexpr double PI = 3.14159265358979323846;
+
+static constexpr double constexprSin(double x) {
+    while (x > PI) {
+        x -= 2 * PI;
+    }
+    while (x < -PI) {
+        x += 2 * PI;
+    }
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+// 第一类零阶修正贝塞尔函数
+static constexpr double besselI0(const double x) {
+    double term = 1.0;
+    double sum = 1.0;
+    for (int k = 1; k < 40; k++) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+static constexpr double constexprSqrt(const double x) {
+    double guess = x > 1.0 ? x : 1.0;
+    for (int i = 0; i < 40; i++) {
+        guess = 0.5 * (guess + x / guess);
+    }
+    return guess;
+}
+
+template <uint16_t UP, uint8_t TAPS>
+struct PolyphaseTable {
+    int16_t coefficients[UP][TAPS];
+};
+
+// 原型滤波器工作在 UP 倍输入采样率上，截止频率取输入、输出中较低者奈奎斯特频率的91%，
+// Kaiser beta = 8（阻带约80dB）。过渡带宽约为 5.0 x 较高采样率 / TAPS：TAPS = 64 时 48kHz 输入约3.8kHz，
+// 即 18.2–21.9kHz，22.05kHz 以上的输入混叠到 20–22kHz 后约为 -80dB；22.05kHz 输入落在 11.025kHz 以上的镜像同样约为 -80dB，
+// 实测见 ResamplerTest（Q15 系数限制了阻带）。每相归一化为单位直流增益后转为 Q15，抽头逆序存放，使内循环按内存正序与历史样本相乘
+template <uint16_t UP, uint16_t DOWN, uint8_t TAPS>
+static constexpr PolyphaseTable<UP, TAPS> makeTable() {
+    constexpr uint32_t LENGTH = UP * TAPS;
+    constexpr double BETA = 8.0;
+    constexpr double CUTOFF = 0.91 * 0.5 / (UP > DOWN ? UP : DOWN);
+    PolyphaseTable<UP, TAPS> table{};
+    double prototype[UP][TAPS]{};
+    for (uint16_t p = 0; p < UP; p++) {
+        double sum = 0.0;
+        for (uint8_t t = 0; t < TAPS; t++) {
+            const double m = p + static_cast<double>(t) * UP;
+            const double centered = m - (LENGTH - 1) / 2.0;
+            const double x = 2.0 * PI * CUTOFF * centered;
+            const double sinc = centered == 0.0 ? 1.0 : constexprSin(x) / x;
+            const double ratio = 2.0 * m / (LENGTH - 1) - 1.0;
+            const double window = besselI0(BETA * constexprSqrt(1.0 - ratio * ratio)) / besselI0(BETA);
+            prototype[p][t] = sinc * window;
+            sum += prototype[p][t];
+        }
+        for (uint8_t t = 0; t < TAPS; t++) {
+            const double scaled = prototype[p][t] / sum * 32768.0;
+            const double rounded = scaled < 0 ? scaled - 0.5 : scaled + 0.5;
+            const int32_t value = static_cast<int32_t>(rounded);
+            table.coefficients[p][TAPS - 1 - t] = static_cast<int16_t>(value > 32767 ? 32767 : value);
+        }
+    }
+    return table;
+}
+
+static constexpr auto FROM_48000 = makeTable<147, 160, Resampler::TAPS>();
+static constexpr auto FROM_22050 = makeTable<2, 1, Resampler::TAPS>();
+
+struct Ratio {
+    uint32_t rate;
+    uint16_t up;
+    uint16_t down;
+    const int16_t* table;
+};
+
+static constexpr Ratio RATIOS[] = {
+    {48000, 147, 160, &FROM_48000.coefficients[0][0]},
+    {22050, 2, 1, &FROM_22050.coefficients[0][0]},
+};
+
+bool Resampler::configure(const uint32_t inputRate) {
+    reset();
+    table = nullptr;
+    if (inputRate == OUTPUT_RATE) {
+        return true;
+    }
+    for (const Ratio& ratio : RATIOS) {
+        if (ratio.rate == inputRate) {
+            table = ratio.table;
+            up = ratio.up;
+            down = ratio.down;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Resampler::reset() {
+    phase = 0;
+    start = 0;
+    memset(history, 0, sizeof(history));
+}
+
+void Resampler::process(const int16_t* samples, const uint32_t frames, const uint8_t channels, const Sink sink,
+                        void* arg) {
+    const uint8_t right = channels > 1 ? 1 : 0;
+    for (uint32_t offset = 0; offset < frames; offset += CHUNK_FRAMES) {
+        const uint16_t count = frames - offset < CHUNK_FRAMES ? frames - offset : CHUNK_FRAMES;
+        const int16_t* frame = samples + offset * channels;
+        for (uint16_t i = 0; i < count; i++, frame += channels) {
+            history[0][HISTORY + i] = frame[0];
+            history[1][HISTORY + i] = frame[right];
+        }
+        const uint32_t produced = convert(count);
+        if (produced) {
+            sink(output, produced, arg);
+        }
+    }
+}
+
+static inline uint32_t load32(const int16_t* pointer) {
+    uint32_t word;
+    memcpy(&word, pointer, sizeof(word));
+    return word;
+}
+
+// 历史中 [0, HISTORY) 为上一块的尾部，[HISTORY, HISTORY + frames) 为本块输入；
+// 窗口完全落在已有样本内的输出都在本块产生，剩余的起点和相位留给下一块
+uint32_t Resampler::convert(const uint16_t frames) {
+    uint32_t produced = 0;
+    int16_t* out = output;
+    while (start < frames) {
+        const int16_t* coefficients = table + phase * TAPS;
+        const int16_t* left = history[0] + start;
+        const int16_t* right = history[1] + start;
+        int32_t accumulatorL = 1 << 14;
+        int32_t accumulatorR = 1 << 14;
+        for (uint8_t t = 0; t < TAPS / 2; t++) {
+            const uint32_t pair = load32(coefficients + 2 * t);
+            accumulatorL = smlad(pair, load32(left + 2 * t), accumulatorL);
+            accumulatorR = smlad(pair, load32(right + 2 * t), accumulatorR);
+        }
+        *out++ = static_cast<int16_t>(ssat16(accumulatorL >> 15));
+        *out++ = static_cast<int16_t>(ssat16(accumulatorR >> 15));
+        produced++;
+        phase += down;
+        start += phase / up;
+        phase %= up;
+    }
+    memmove(history[0], history[0] + frames, HISTORY * sizeof(int16_t));
+    memmove(history[1], history[1] + frames, HISTORY * sizeof(int16_t));
+    start -= frames;
+    return produced;
+}
@@ -0,0 +1,48 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+#include <stdint.h>
+
+// 流式多相采样率转换：把解码输出统一转换到 OUTPUT_RATE，I2S 位时钟不再随曲目切换。
+// 每个支持的输入采样率对应一张编译期生成的 Kaiser 窗 sinc 多相系数表（UP 相 x TAPS 抽头，48kHz 的表占约18KB 闪存）；
+// 两个声道的历史按平面存放，内循环每次用 SMLAD 做两个抽头的乘加
+class Resampler {
+public:
+    static constexpr uint32_t OUTPUT_RATE = 44100;
+    static constexpr uint8_t TAPS = 64;
+    static constexpr uint16_t CHUNK_FRAMES = 256;
+
+    // 每次交出 frames 帧交织的16位立体声样本
+    using Sink = void (*)(const int16_t* samples, uint32_t frames, void* arg);
+
+    // 选择 inputRate -> OUTPUT_RATE 的系数表并清空历史；等于 OUTPUT_RATE 时直通。
+    // 不支持的采样率返回 false，由调用者改为切换输出时钟
+    bool configure(uint32_t inputRate);
+
+    // 清空历史，曲目之间调用
+    void reset();
+
+    // 需要转换（而非直通）时为 true
+    [[nodiscard]] bool isActive() const {
+        return table != nullptr;
+    }
+
+    // 转换交织输入（单声道复制到两个声道，多于两个声道时只取前两个），按块交给 sink
+    void process(const int16_t* samples, uint32_t frames, uint8_t channels, Sink sink, void* arg);
+
+private:
+    static constexpr uint16_t HISTORY = TAPS - 1;
+    // 最大上采样倍数为2（22.05kHz -> 44.1kHz）
+    static constexpr uint16_t MAX_OUTPUT_FRAMES = CHUNK_FRAMES * 2 + 2;
+
+    const int16_t* table = nullptr; // [up][TAPS]，每相的抽头按时间正序
+    uint16_t up = 1;
+    uint16_t down = 1;
+    uint16_t phase = 0;
+    uint16_t start = 0; // 下一个输出的窗口在历史中的起点
+    int16_t history[2][HISTORY + CHUNK_FRAMES]{};
+    int16_t output[MAX_OUTPUT_FRAMES * 2]{};
+
+    uint32_t convert(uint16_t frames);
+};
+
+#endif // RESAMPLER_H
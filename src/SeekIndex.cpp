@@ -0,0 +1,406 @@
+#include "SeekIndex.h"
+#include <string.h>
+
+static constexpr uint8_t HEADER_BYTES = 4;
+// MPEG1 320kbps 32kHz 带填充的帧
+static constexpr uint16_t MAX_FRAME_BYTES = 1441;
+static constexpr uint32_t MAGIC = 0x58444953; // "SIDX"
+
+// Layer III 的比特率（kbps），[0] 为 MPEG1，[1] 为 MPEG2/2.5
+static constexpr uint16_t BITRATES[2][15] = {
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},
+};
+static constexpr uint16_t SAMPLE_RATES[3] = {44100, 48000, 32000};
+
+static bool isMpeg1(const uint8_t* header) {
+    return (header[1] >> 3 & 3) == 3;
+}
+
+// 版本位：3 = MPEG1，2 = MPEG2，0 = MPEG2.5
+static uint32_t sampleRateOf(const uint8_t* header) {
+    const uint8_t version = header[1] >> 3 & 3;
+    return SAMPLE_RATES[header[2] >> 2 & 3] >> (version == 3 ? 0 : version == 2 ? 1 : 2);
+}
+
+// 合法的 Layer III 帧头返回帧长，自由比特率与其余层返回0
+static uint32_t layer3Bytes(const uint8_t* header) {
+    if (header[0] != 0xFF || (header[1] & 0xE0) != 0xE0 || (header[1] >> 3 & 3) == 1 || (header[1] >> 1 & 3) != 1) {
+        return 0;
+    }
+    const uint8_t bitrate = header[2] >> 4;
+    if (bitrate == 0 || bitrate == 15 || (header[2] >> 2 & 3) == 3) {
+        return 0;
+    }
+    const bool mpeg1 = isMpeg1(header);
+    return (mpeg1 ? 144 : 72) * BITRATES[mpeg1 ? 0 : 1][bitrate] * 1000 / sampleRateOf(header) + (header[2] >> 1 & 1);
+}
+
+static uint32_t be32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) << 24 | data[1] << 16 | data[2] << 8 | data[3];
+}
+
+static uint16_t be16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] << 8 | data[1]);
+}
+
+void SeekIndex::begin(FileReader& reader, const char* path) {
+    count = 0;
+    stride = INITIAL_STRIDE;
+    covered = 0;
+    complete = false;
+    usable = false;
+    tocCount = 0;
+    fileSize = reader.size();
+    // 只在一个缓冲区内找第一帧，找不到时视为不支持的文件
+    const size_t available = reader.refill();
+    const uint8_t* data = reader.data();
+    size_t skip = 0;
+    while (skip + HEADER_BYTES <= available && layer3Bytes(data + skip) == 0) {
+        skip++;
+    }
+    if (skip + HEADER_BYTES > available) {
+        return;
+    }
+    reader.consume(skip);
+    data = reader.data();
+    memcpy(reference, data, sizeof(reference));
+    firstOffset = reader.tell();
+    samplesPerFrame = isMpeg1(data) ? 1152 : 576;
+    sampleRate = sampleRateOf(data);
+    usable = true;
+
+    scanFrame = 0;
+    scanOffset = 0;
+    const size_t pathLength = strlen(path);
+    trackPath[0] = '\0';
+    if (pathLength < PATH_LENGTH) {
+        memcpy(trackPath, path, pathLength + 1);
+    }
+
+    // FatFs 未启用长文件名，索引文件只替换扩展名
+    const char* dot = strrchr(path, '.');
+    const char* slash = strrchr(path, '/');
+    const size_t stem = dot && (slash == nullptr || dot > slash) ? dot - path : strlen(path);
+    indexPath[0] = '\0';
+    if (stem + sizeof(".IDX") <= PATH_LENGTH) {
+        memcpy(indexPath, path, stem);
+        memcpy(indexPath + stem, ".IDX", sizeof(".IDX"));
+    }
+    if (load()) {
+        return;
+    }
+    add(0, firstOffset);
+    const uint32_t length = layer3Bytes(data);
+    parseToc(data, length < reader.available() ? length : reader.available());
+}
+
+void SeekIndex::record(const uint32_t frame, const uint32_t offset) {
+    if (usable) {
+        add(frame, offset);
+    }
+}
+
+void SeekIndex::finish(FileReader& reader, const uint32_t lastFrame) {
+    if (!usable || complete || lastFrame + 1 != covered) {
+        return;
+    }
+    uint32_t at = covered;
+    walk(reader, at, UINT32_MAX);
+    if (at == covered) {
+        complete = true;
+        save();
+    }
+}
+
+bool SeekIndex::extend(FileReader& reader, const uint16_t frames) {
+    if (!usable || complete || trackPath[0] == '\0') {
+        return false;
+    }
+    if (!reader.isOpen() && !reader.open(trackPath)) {
+        return false;
+    }
+    uint32_t at = covered;
+    if (scanFrame != covered || reader.tell() != scanOffset) {
+        at = (count - 1) * stride;
+        if (!reader.seek(entries[count - 1])) {
+            reader.close();
+            return false;
+        }
+    }
+    if (!walk(reader, at, covered + frames)) {
+        if (at == covered) {
+            complete = true;
+            save();
+        }
+        reader.close();
+        return true;
+    }
+    scanFrame = at;
+    scanOffset = reader.tell();
+    return true;
+}
+
+bool SeekIndex::seek(FileReader& reader, const uint32_t frame, uint32_t& landed) {
+    if (!usable || (complete && frame >= covered)) {
+        return false;
+    }
+    if (tocCount && frame >= covered + TOC_MIN_DISTANCE) {
+        if (!reader.seek(tocOffset(frame)) || !resync(reader)) {
+            return false;
+        }
+        landed = frame;
+        return true;
+    }
+    const uint16_t entry = frame < covered ? frame / stride : count - 1;
+    if (!reader.seek(entries[entry])) {
+        return false;
+    }
+    uint32_t at = entry * stride;
+    if (!walk(reader, at, frame)) {
+        // 扫描到了文件末尾
+        if (!complete && at == covered) {
+            complete = true;
+            save();
+        }
+        return false;
+    }
+    landed = frame;
+    // 不消耗数据，把缓冲区中其后的帧也记入索引：紧接着的预热帧可能因比特池不足不出样本，不会被 record()
+    const size_t available = reader.refill();
+    const uint8_t* data = reader.data();
+    size_t position = 0;
+    while (position + HEADER_BYTES <= available) {
+        const uint32_t bytes = frameBytes(data + position);
+        if (bytes == 0 || position + bytes > available) {
+            break;
+        }
+        add(at++, reader.tell() + position);
+        position += bytes;
+    }
+    return true;
+}
+
+// entries[count] 应为第 count * stride 帧；跳过了该帧（例如它因比特池不足没有输出）时不再扩展
+void SeekIndex::add(const uint32_t frame, const uint32_t offset) {
+    if (complete || frame < covered || frame > count * stride) {
+        return;
+    }
+    covered = frame + 1;
+    if (frame != count * stride) {
+        return;
+    }
+    if (count == MAX_ENTRIES) {
+        for (uint16_t i = 0; i < MAX_ENTRIES / 2; i++) {
+            entries[i] = entries[2 * i];
+        }
+        count = MAX_ENTRIES / 2;
+        stride *= 2;
+    }
+    entries[count++] = offset;
+}
+
+// 只解析帧头，逐帧跳到第 until 帧；返回 false 表示先到了文件末尾
+bool SeekIndex::walk(FileReader& reader, uint32_t& frame, const uint32_t until) {
+    while (frame < until) {
+        if (reader.available() < MAX_FRAME_BYTES) {
+            reader.refill();
+        }
+        if (reader.available() < HEADER_BYTES) {
+            return false;
+        }
+        const uint32_t bytes = frameBytes(reader.data());
+        if (bytes == 0) {
+            reader.consume(1);
+            if (!resync(reader)) {
+                return false;
+            }
+            continue;
+        }
+        if (bytes > reader.available()) {
+            return false;
+        }
+        add(frame, reader.tell());
+        reader.consume(bytes);
+        frame++;
+    }
+    return true;
+}
+
+// 消耗到下一个合法帧头为止；缓冲区中放得下时还要求其后紧跟另一个合法帧头
+bool SeekIndex::resync(FileReader& reader) {
+    while (true) {
+        if (reader.available() < MAX_FRAME_BYTES + HEADER_BYTES) {
+            reader.refill();
+        }
+        const uint8_t* data = reader.data();
+        const size_t available = reader.available();
+        if (available < HEADER_BYTES) {
+            return false;
+        }
+        size_t skip = 0;
+        for (; skip + HEADER_BYTES <= available; skip++) {
+            const uint32_t bytes = frameBytes(data + skip);
+            if (bytes && (skip + bytes + HEADER_BYTES > available || frameBytes(data + skip + bytes))) {
+                break;
+            }
+        }
+        reader.consume(skip);
+        if (skip + HEADER_BYTES <= available) {
+            return true;
+        }
+    }
+}
+
+// 版本、层与采样率须与第一帧相同，减少在音频数据中误判帧头
+uint32_t SeekIndex::frameBytes(const uint8_t* header) const {
+    if ((header[1] & 0x1E) != (reference[1] & 0x1E) || (header[2] & 0x0C) != (reference[2] & 0x0C)) {
+        return 0;
+    }
+    return layer3Bytes(header);
+}
+
+uint32_t SeekIndex::tocOffset(const uint32_t frame) const {
+    const uint64_t position = static_cast<uint64_t>(frame) * 256;
+    const uint32_t point = position / tocStep;
+    if (point >= tocCount) {
+        return tocOffsets[tocCount];
+    }
+    const uint32_t from = tocOffsets[point];
+    const uint32_t to = tocOffsets[point + 1];
+    return to > from ? from + static_cast<uint64_t>(to - from) * (position % tocStep) / tocStep : from;
+}
+
+// Xing/Info 标签在边信息之后，目录为100个按时长百分比取的字节位置（以文件音频长度的1/256计）；
+// VBRI 标签固定在帧头后32字节，目录为每 framesPerEntry 帧的字节增量，条目过多时合并相邻条目
+void SeekIndex::parseToc(const uint8_t* frame, const uint32_t length) {
+    const bool mono = frame[3] >> 6 == 3;
+    const uint32_t xing = HEADER_BYTES + (isMpeg1(frame) ? (mono ? 17 : 32) : (mono ? 9 : 17));
+    if (xing + 8 <= length && (memcmp(frame + xing, "Xing", 4) == 0 || memcmp(frame + xing, "Info", 4) == 0)) {
+        const uint32_t flags = be32(frame + xing + 4);
+        uint32_t field = xing + 8;
+        uint32_t frames = 0;
+        uint32_t bytes = fileSize - firstOffset;
+        if (flags & 1) {
+            frames = be32(frame + field);
+            field += 4;
+        }
+        if (flags & 2) {
+            bytes = be32(frame + field);
+            field += 4;
+        }
+        if (!(flags & 4) || frames < 100 || field + 100 > length) {
+            return;
+        }
+        for (uint8_t i = 0; i < 100; i++) {
+            tocOffsets[i] = firstOffset + static_cast<uint64_t>(frame[field + i]) * bytes / 256;
+        }
+        tocOffsets[100] = firstOffset + bytes;
+        tocCount = 100;
+        tocStep = static_cast<uint64_t>(frames) * 256 / 100;
+        return;
+    }
+    constexpr uint32_t VBRI = HEADER_BYTES + 32;
+    if (VBRI + 26 > length || memcmp(frame + VBRI, "VBRI", 4) != 0) {
+        return;
+    }
+    const uint8_t* vbri = frame + VBRI;
+    const uint16_t points = be16(vbri + 18);
+    const uint16_t scale = be16(vbri + 20);
+    const uint16_t entryBytes = be16(vbri + 22);
+    const uint16_t framesPerEntry = be16(vbri + 24);
+    if (points == 0 || entryBytes == 0 || entryBytes > 4 || framesPerEntry == 0 ||
+        VBRI + 26 + static_cast<uint32_t>(points) * entryBytes > length) {
+        return;
+    }
+    const uint16_t group = (points + TOC_SIZE - 1) / TOC_SIZE;
+    const uint8_t* table = vbri + 26;
+    uint32_t offset = firstOffset;
+    for (uint16_t i = 0; i < points; i++) {
+        if (i % group == 0) {
+            tocOffsets[tocCount++] = offset;
+        }
+        uint32_t delta = 0;
+        for (uint16_t b = 0; b < entryBytes; b++) {
+            delta = delta << 8 | *table++;
+        }
+        offset += delta * scale;
+    }
+    tocOffsets[tocCount] = offset;
+    tocStep = static_cast<uint32_t>(framesPerEntry) * group * 256;
+}
+
+// 文件大小、第一帧位置与帧头都须与当前文件一致，否则视为别的文件留下的索引
+bool SeekIndex::load() {
+    if (indexPath[0] == '\0') {
+        return false;
+    }
+    FileHeader header{};
+    const auto valid = [this, &header] {
+        return header.magic == MAGIC && header.fileSize == fileSize && header.firstOffset == firstOffset &&
+               memcmp(header.reference, reference, sizeof(reference)) == 0 && header.stride > 0 &&
+               header.count > 0 && header.count <= MAX_ENTRIES &&
+               header.count == (header.frames + header.stride - 1) / header.stride;
+    };
+#if PICO_ON_DEVICE
+    FIL file{};
+    if (f_open(&file, indexPath, FA_READ) != FR_OK) {
+        return false;
+    }
+    UINT read = 0;
+    bool loaded = f_read(&file, &header, sizeof(header), &read) == FR_OK && read == sizeof(header) && valid();
+    loaded = loaded && f_read(&file, entries, header.count * sizeof(entries[0]), &read) == FR_OK &&
+             read == header.count * sizeof(entries[0]);
+    f_close(&file);
+#else
+    FILE* file = fopen(indexPath, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool loaded = fread(&header, sizeof(header), 1, file) == 1 && valid();
+    loaded = loaded && fread(entries, sizeof(entries[0]), header.count, file) == header.count;
+    fclose(file);
+#endif
+    if (!loaded) {
+        return false;
+    }
+    count = header.count;
+    stride = header.stride;
+    covered = header.frames;
+    complete = true;
+    return true;
+}
+
+// 写入失败（写保护、卡满）时删除写了一半的文件，下次播放重新建立
+void SeekIndex::save() const {
+    if (indexPath[0] == '\0') {
+        return;
+    }
+    FileHeader header{MAGIC, fileSize, firstOffset, covered, stride, count, {}};
+    memcpy(header.reference, reference, sizeof(reference));
+#if PICO_ON_DEVICE
+    FIL file{};
+    if (f_open(&file, indexPath, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) {
+        return;
+    }
+    const UINT entryBytes = count * sizeof(entries[0]);
+    UINT written = 0;
+    bool saved = f_write(&file, &header, sizeof(header), &written) == FR_OK && written == sizeof(header);
+    saved = saved && f_write(&file, entries, entryBytes, &written) == FR_OK && written == entryBytes;
+    saved = f_close(&file) == FR_OK && saved;
+    if (!saved) {
+        f_unlink(indexPath);
+    }
+#else
+    FILE* file = fopen(indexPath, "wb");
+    if (file == nullptr) {
+        return;
+    }
+    bool saved = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 fwrite(entries, sizeof(entries[0]), count, file) == count;
+    saved = fclose(file) == 0 && saved;
+    if (!saved) {
+        remove(indexPath);
+    }
+#endif
+}
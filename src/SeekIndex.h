@@ -0,0 +1,102 @@
+#ifndef SEEK_INDEX_H
+#define SEEK_INDEX_H
+#include <stdint.h>
+#include "FileReader.h"
+
+// MP3 帧定位索引：entries[i] 为第 i * stride 帧的起点，帧号从 ID3v2 标签后的第一帧（含 Xing/Info 帧）起算。
+// 索引在播放时随解码顺带记录，core 1 空闲时借 StartCache 的文件读取器在后台只解析帧头向后扫描（extend()），
+// 定位到仍未覆盖的位置时同样逐帧补齐；条目用满后隔一删一、步长加倍，内存固定。
+// 覆盖整个文件后以同名 .IDX 文件保存在卡上，下次打开直接载入。
+// 定位时按帧号直接取条目，一次 seek 读入缓冲区后最多跳过 stride - 1 个帧头。
+// 离已覆盖部分较远且文件带 Xing/VBRI 目录时，按目录估算字节位置后重新同步，帧号为估计值。
+// 只支持 Layer III 且不是自由比特率的文件；FLAC 的定位由 libFLAC 完成（有 SEEKTABLE 时查表，否则二分）
+class SeekIndex {
+public:
+    static constexpr uint16_t MAX_ENTRIES = 2048; // 8KB，60分钟 44.1kHz 的文件步长为128帧（约3.3s）
+    static constexpr uint16_t INITIAL_STRIDE = 8;
+    static constexpr uint8_t TOC_SIZE = 128;
+    // 目标离已覆盖部分在此帧数以内时逐帧跳过帧头，不用目录估算
+    static constexpr uint16_t TOC_MIN_DISTANCE = 64;
+    static constexpr uint16_t PATH_LENGTH = 64;
+
+    // 解析 reader 当前位置（ID3v2 标签之后）的第一帧，读取 Xing/VBRI 目录并载入已保存的索引；
+    // 跳过第一帧之前的非音频数据，不消耗第一帧
+    void begin(FileReader& reader, const char* path);
+
+    // 播放时解出的帧，与已覆盖部分相接时扩展索引
+    void record(uint32_t frame, uint32_t offset);
+
+    // 解码结束（文件末尾或末尾填充），lastFrame 为最后解出的帧，reader 位于其后；
+    // 索引与之相接时只解析帧头扫完剩余部分，覆盖了整个文件时保存
+    void finish(FileReader& reader, uint32_t lastFrame);
+
+    // 后台扫描：在另一个 reader 上从已覆盖部分的末尾起最多解析 frames 个帧头，reader 未打开时打开本曲目；
+    // 播放或定位期间索引被扩展过、reader 被别处重新打开时从最后一个条目重新开始。
+    // 扫到文件末尾时保存并关闭 reader；索引已完整或不可用时返回 false
+    bool extend(FileReader& reader, uint16_t frames);
+
+    // 曲目关闭，之后的 record()/finish()/extend() 不再生效
+    void close() {
+        usable = false;
+    }
+
+    // 把 reader 定位到第 frame 帧的起点，landed 为实际到达的帧号（按目录估算时为估计值）。
+    // 不可定位或超出文件末尾时返回 false，此时 reader 的位置不确定
+    bool seek(FileReader& reader, uint32_t frame, uint32_t& landed);
+
+    [[nodiscard]] bool isUsable() const {
+        return usable;
+    }
+
+    [[nodiscard]] uint32_t getSampleRate() const {
+        return sampleRate;
+    }
+
+    [[nodiscard]] uint16_t getSamplesPerFrame() const {
+        return samplesPerFrame;
+    }
+
+private:
+    // 保存的索引文件头，后接 count 个条目
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t fileSize;
+        uint32_t firstOffset;
+        uint32_t frames;
+        uint16_t stride;
+        uint16_t count;
+        uint8_t reference[4];
+    };
+
+    uint32_t entries[MAX_ENTRIES]{};
+    uint16_t count = 0;
+    uint16_t stride = INITIAL_STRIDE;
+    uint32_t covered = 0; // 从第0帧起连续解析过的帧数
+    bool complete = false;
+    bool usable = false;
+    uint8_t reference[4]{}; // 第一帧的帧头，用于重新同步时排除误判
+    uint32_t sampleRate = 0;
+    uint16_t samplesPerFrame = 0;
+    uint32_t fileSize = 0;
+    uint32_t firstOffset = 0;
+    // 目录第 i 点对应第 i * tocStep / 256 帧，tocOffsets[tocCount] 为音频数据末尾
+    uint32_t tocOffsets[TOC_SIZE + 1]{};
+    uint8_t tocCount = 0;
+    uint32_t tocStep = 0;
+    char trackPath[PATH_LENGTH]{};
+    char indexPath[PATH_LENGTH]{};
+    // 后台扫描的位置：第 scanFrame 帧的起点为 scanOffset，与 covered 不符时重新开始
+    uint32_t scanFrame = 0;
+    uint32_t scanOffset = 0;
+
+    void add(uint32_t frame, uint32_t offset);
+    bool walk(FileReader& reader, uint32_t& frame, uint32_t until);
+    bool resync(FileReader& reader);
+    [[nodiscard]] uint32_t frameBytes(const uint8_t* header) const;
+    [[nodiscard]] uint32_t tocOffset(uint32_t frame) const;
+    void parseToc(const uint8_t* frame, uint32_t length);
+    bool load();
+    void save() const;
+};
+
+#endif // SEEK_INDEX_H
@@ -0,0 +1,40 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+#include <stdint.h>
+#include <atomic>
+
+// 单生产者/单消费者无锁环形队列，生产者可以是中断，消费者是任务
+template <typename T, uint16_t N>
+class SpscRing {
+    static_assert((N & (N - 1)) == 0, "N must be a power of two");
+    T items[N]{};
+    std::atomic<uint16_t> head{0};
+    std::atomic<uint16_t> tail{0};
+
+public:
+    bool push(const T& item) {
+        const uint16_t t = tail.load(std::memory_order_relaxed);
+        if (static_cast<uint16_t>(t - head.load(std::memory_order_acquire)) == N) {
+            return false;
+        }
+        items[t % N] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        const uint16_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[h % N];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] uint16_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,136 @@
+#include "StartCache.h"
+
+void StartCache::assign(const uint8_t slot, const char* path) {
+    if (slot >= SLOTS) {
+        return;
+    }
+    Entry& entry = entries[slot];
+    if (entry.state != State::EMPTY && strncmp(entry.path, path, PATH_LENGTH - 1) == 0) {
+        return;
+    }
+    if (filling == &entry) {
+        end(State::EMPTY);
+    }
+    strncpy(entry.path, path, PATH_LENGTH - 1);
+    entry.path[PATH_LENGTH - 1] = '\0';
+    entry.state = entry.path[0] ? State::PENDING : State::EMPTY;
+}
+
+bool StartCache::hasWork() const {
+    if (filling) {
+        return true;
+    }
+    for (const Entry& entry : entries) {
+        if (entry.state == State::PENDING) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool StartCache::step() {
+    if (filling == nullptr) {
+        for (Entry& entry : entries) {
+            if (entry.state == State::PENDING) {
+                begin(entry);
+                return true;
+            }
+        }
+        return false;
+    }
+    if (filling->format == AudioFormat::MP3) {
+        return stepMp3();
+    }
+    const uint32_t samples = flac.decode();
+    if (full || samples == 0) {
+        filling->complete = !full;
+        filling->resumeSample = filling->frames;
+        end(State::READY);
+    }
+    return true;
+}
+
+StartCache::Entry* StartCache::find(const char* path) {
+    for (Entry& entry : entries) {
+        if (entry.state == State::READY && strncmp(entry.path, path, PATH_LENGTH - 1) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void StartCache::begin(Entry& entry) {
+    entry.format = formatOf(entry.path);
+    entry.complete = false;
+    entry.sampleRate = 0;
+    entry.frames = 0;
+    if (entry.format == AudioFormat::VORBIS || !reader.open(entry.path)) {
+        entry.state = State::FAILED;
+        return;
+    }
+    filling = &entry;
+    entry.state = State::FILLING;
+    decodedFrames = 0;
+    full = false;
+    if (entry.format == AudioFormat::MP3) {
+        mp3.start(reader);
+    } else if (flac.start(reader, appendFlac, this)) {
+        entry.sampleRate = flac.getSampleRate();
+    } else {
+        end(State::FAILED);
+    }
+}
+
+void StartCache::end(const State state) {
+    flac.finish();
+    reader.close();
+    filling->state = state;
+    filling = nullptr;
+}
+
+// 缓存放不下下一帧时停止：该帧即恢复后的第一帧，从它之前 WARMUP_FRAMES 帧处开始重新解码
+bool StartCache::stepMp3() {
+    const uint32_t samples = mp3.decode(reader);
+    if (samples == 0) {
+        filling->complete = true;
+        end(filling->frames ? State::READY : State::FAILED);
+        return true;
+    }
+    offsets[decodedFrames % (WARMUP_FRAMES + 1)] = mp3.getFrameOffset();
+    frameNumbers[decodedFrames % (WARMUP_FRAMES + 1)] = mp3.getFrameNumber();
+    if (filling->frames == 0) {
+        filling->sampleRate = mp3.getSampleRate();
+    }
+    if (filling->frames + samples > CACHE_FRAMES) {
+        const uint32_t resumeFrame = decodedFrames >= WARMUP_FRAMES ? decodedFrames - WARMUP_FRAMES : 0;
+        filling->resumeOffset = offsets[resumeFrame % (WARMUP_FRAMES + 1)];
+        filling->resumeFrame = frameNumbers[resumeFrame % (WARMUP_FRAMES + 1)];
+        filling->lastOffset = offsets[(decodedFrames - 1) % (WARMUP_FRAMES + 1)];
+        end(State::READY);
+        return true;
+    }
+    append(mp3.pcm(), samples, mp3.getChannels());
+    decodedFrames++;
+    return true;
+}
+
+void StartCache::append(const int16_t* samples, const uint32_t frames, const uint8_t channels) {
+    int16_t* out = filling->pcm + filling->frames * 2;
+    const uint8_t right = channels > 1 ? 1 : 0;
+    for (uint32_t i = 0; i < frames; i++, samples += channels) {
+        *out++ = samples[0];
+        *out++ = samples[right];
+    }
+    filling->frames += frames;
+}
+
+// FLAC 可按样本定位，缓存正好填满，多出的部分丢弃
+void StartCache::appendFlac(const int16_t* samples, const uint32_t frames, void* arg) {
+    auto* self = static_cast<StartCache*>(arg);
+    if (self->full) {
+        return;
+    }
+    const uint32_t room = CACHE_FRAMES - self->filling->frames;
+    self->append(samples, frames < room ? frames : room, 2);
+    self->full = self->filling->frames == CACHE_FRAMES;
+}
@@ -0,0 +1,80 @@
+#ifndef START_CACHE_H
+#define START_CACHE_H
+#include <stdint.h>
+#include "AudioFormat.h"
+#include "FileReader.h"
+#include "Mp3Decoder.h"
+#include "FlacDecoder.h"
+
+// 曲目起始缓存：利用 core 1 的空闲时间把播放队列中相邻曲目（下一首、上一首）的开头约250ms
+// 预先解码为交织的16位立体声。切到这些曲目时先输出缓存，同时重新打开文件，把解码器恢复到缓存末尾接着解码：
+// MP3 从缓存末尾前 WARMUP_FRAMES 帧处重新解码并丢弃输出，以恢复比特池和 IMDCT 重叠状态；FLAC 按样本号定位。
+// Ogg Vorbis 的解码器独占 VorbisArena，不能与正在播放的曲目同时打开，因此不做预解码
+class StartCache {
+public:
+    static constexpr uint8_t SLOTS = 2;
+    static constexpr uint32_t CACHE_FRAMES = 11520; // 44.1kHz 下约261ms，每个槽位约46KB
+    static constexpr uint8_t WARMUP_FRAMES = 4;
+    static constexpr uint16_t PATH_LENGTH = 64;
+
+    enum class State : uint8_t {
+        EMPTY, PENDING, FILLING, READY, FAILED
+    };
+
+    struct Entry {
+        char path[PATH_LENGTH];
+        State state;
+        AudioFormat format;
+        bool complete; // 整首都在缓存中
+        uint32_t sampleRate;
+        uint32_t frames;
+        uint32_t resumeOffset; // MP3：恢复解码的起点
+        uint32_t resumeFrame;  // MP3：恢复起点的帧号
+        uint32_t lastOffset;   // MP3：缓存中最后一帧的起点，解码到它为止的输出都丢弃
+        uint64_t resumeSample; // FLAC：缓存之后的第一个样本
+        int16_t pcm[CACHE_FRAMES * 2];
+    };
+
+    // 指定槽位要预解码的曲目：路径未变时保留已有的缓存，空路径清空槽位
+    void assign(uint8_t slot, const char* path);
+
+    // 还有待预解码的曲目
+    [[nodiscard]] bool hasWork() const;
+
+    // 做一步预解码（打开文件、一个 MP3 帧或一个 FLAC 帧），没有可做的工作时返回 false
+    bool step();
+
+    // 没有正在预解码的曲目时文件读取器空闲，借给当前曲目的后台索引；下一次开始预解码时重新打开。
+    // 正在预解码时返回 nullptr
+    [[nodiscard]] FileReader* idleReader() {
+        return filling == nullptr ? &reader : nullptr;
+    }
+
+    // 已完成预解码的曲目，没有时返回 nullptr
+    [[nodiscard]] Entry* find(const char* path);
+
+    // 缓存已被播放使用，清空槽位
+    void consume(Entry* entry) {
+        entry->state = State::EMPTY;
+        entry->path[0] = '\0';
+    }
+
+private:
+    Entry entries[SLOTS]{};
+    FileReader reader;
+    Mp3Decoder mp3;
+    FlacDecoder flac;
+    Entry* filling = nullptr;
+    uint32_t offsets[WARMUP_FRAMES + 1]{}; // 最近几个 MP3 帧的起点，按帧序号取模
+    uint32_t frameNumbers[WARMUP_FRAMES + 1]{};
+    uint32_t decodedFrames = 0;
+    bool full = false;
+
+    void begin(Entry& entry);
+    void end(State state);
+    void append(const int16_t* samples, uint32_t frames, uint8_t channels);
+    bool stepMp3();
+    static void appendFlac(const int16_t* samples, uint32_t frames, void* arg);
+};
+
+#endif // START_CACHE_H
@@ -0,0 +1,65 @@
+#ifndef STATE_LATCH_H
+#define STATE_LATCH_H
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+// 单写多读的双缓冲顺序锁：写者先后改写两份副本，读者总是读未被改写的那份，
+// 只在读取期间写者切换了副本时重试。读者不会等待写者，可在任意任务或中断中调用
+template <typename T>
+class StateLatch {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+    static constexpr size_t WORDS = (sizeof(T) + 3) / 4;
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint32_t> copies[2][WORDS]{};
+    mutable std::atomic<uint32_t> retries{0};
+
+    void store(std::atomic<uint32_t>* copy, const uint32_t* words) {
+        for (size_t i = 0; i < WORDS; i++) {
+            copy[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+public:
+    // 只能由一个写者调用
+    void publish(const T& value) {
+        uint32_t words[WORDS]{};
+        memcpy(words, &value, sizeof(T));
+        const uint32_t s = sequence.load(std::memory_order_relaxed);
+        // 序号为奇数时读者读副本1，此时改写副本0；序号为偶数时反之
+        sequence.store(s + 1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        store(copies[0], words);
+        sequence.store(s + 2, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        store(copies[1], words);
+    }
+
+    [[nodiscard]] T read() const {
+        uint32_t words[WORDS];
+        uint32_t s;
+        while (true) {
+            s = sequence.load(std::memory_order_acquire);
+            const std::atomic<uint32_t>* copy = copies[s & 1];
+            for (size_t i = 0; i < WORDS; i++) {
+                words[i] = copy[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == s) {
+                break;
+            }
+            retries.fetch_add(1, std::memory_order_relaxed);
+        }
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    // 读者因写者切换副本而重读的累计次数
+    [[nodiscard]] uint32_t getRetries() const {
+        return retries.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // STATE_LATCH_H
@@ -0,0 +1,279 @@
+#include "TF16PEmulator.h"
+
+void TF16PEmulator::connect(const Sink sink, void* arg) {
+    sinkArg = arg;
+    this->sink = sink;
+    reply(INIT, device, config.bootMs * 1000);
+}
+
+void TF16PEmulator::receive(const uint8_t* data, const size_t length) {
+    critical_section_enter_blocking(&lock);
+    for (size_t i = 0; i < length; i++) {
+        const uint32_t errors = parser.getChecksumErrors();
+        if (parser.push(data[i])) {
+            handle(parser.frame());
+        } else if (parser.getChecksumErrors() != errors) {
+            reply(ERR, 0x04);
+        }
+    }
+    critical_section_exit(&lock);
+}
+
+void TF16PEmulator::setFaults(const uint16_t lossPerMille, const uint16_t corruptPerMille,
+                              const uint16_t busyPerMille) {
+    critical_section_enter_blocking(&lock);
+    config.lossPerMille = lossPerMille;
+    config.corruptPerMille = corruptPerMille;
+    config.busyPerMille = busyPerMille;
+    critical_section_exit(&lock);
+}
+
+void TF16PEmulator::dropReplies(const uint8_t count) {
+    critical_section_enter_blocking(&lock);
+    repliesToDrop = count;
+    critical_section_exit(&lock);
+}
+
+uint32_t TF16PEmulator::nextRandom() {
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return random;
+}
+
+uint16_t TF16PEmulator::trackTotal() const {
+    return config.folders * config.filesPerFolder;
+}
+
+void TF16PEmulator::handle(const TF16PFrame& frame) {
+    framesReceived++;
+    const uint8_t cmd = frame.command();
+    const uint16_t arg = frame.argument();
+    if (sleeping && cmd != WAKEUP && cmd != RESET) {
+        reply(ERR, 0x02);
+        return;
+    }
+    if (config.busyPerMille && nextRandom() % 1000 < config.busyPerMille) {
+        reply(ERR, 0x01);
+        return;
+    }
+    // 播放类命令先换算成全局曲目号，越界时回复错误码5
+    bool plays = true;
+    uint16_t folder = 1;
+    uint16_t file = 0;
+    switch (cmd) {
+    case NEXT:
+        file = track < trackTotal() ? track + 1 : 1;
+        break;
+    case PREVIOUS:
+        file = track > 1 ? track - 1 : trackTotal();
+        break;
+    case PLAY:
+        file = arg;
+        break;
+    case PLAY_FOLDER:
+        folder = arg >> 8;
+        file = arg & 0xFF;
+        break;
+    case PLAY_LARGE_FOLDER:
+        folder = arg >> 12;
+        file = arg & 0x0FFF;
+        break;
+    case LOOP_FOLDER:
+        folder = arg;
+        file = 1;
+        break;
+    default:
+        plays = false;
+        break;
+    }
+    if (plays && (folder < 1 || folder > config.folders || file < 1 ||
+                  file > (cmd == PLAY_FOLDER || cmd == PLAY_LARGE_FOLDER ? config.filesPerFolder : trackTotal()))) {
+        reply(ERR, 0x05);
+        return;
+    }
+    const uint16_t target = (folder - 1) * config.filesPerFolder + file;
+    if (frame.bytes[4]) {
+        reply(ACK, 0);
+    }
+
+    switch (cmd) {
+    case NEXT:
+    case PREVIOUS:
+    case PLAY:
+    case PLAY_FOLDER:
+    case PLAY_LARGE_FOLDER:
+    case LOOP_FOLDER:
+        loopFolder = cmd == LOOP_FOLDER ? folder : 0;
+        startTrack(target);
+        break;
+    case VOLUME:
+        volume = arg > 30 ? 30 : arg;
+        break;
+    case DEVICE:
+        device = arg & 0xFF;
+        break;
+    case STANDBY:
+        sleeping = true;
+        break;
+    case WAKEUP:
+        sleeping = false;
+        break;
+    case RESET:
+        loopFolder = 0;
+        stopTrack();
+        sleeping = false;
+        reply(INIT, device, config.bootMs * 1000);
+        break;
+    case RESUME:
+        if (paused) {
+            paused = false;
+            playing = true;
+            trackStartedAt = time_us_64();
+            armFinish(remainingMs);
+        }
+        break;
+    case PAUSE:
+        if (playing) {
+            const uint32_t elapsedMs = (time_us_64() - trackStartedAt) / 1000;
+            remainingMs = remainingMs > elapsedMs ? remainingMs - elapsedMs : 1;
+            stopTrack();
+            paused = true;
+        }
+        break;
+    case STOP:
+        loopFolder = 0;
+        stopTrack();
+        break;
+    case STAT:
+        reply(STAT, device << 8 | (playing ? 1 : paused ? 2 : 0));
+        break;
+    case QUERY_VOLUME:
+        reply(QUERY_VOLUME, volume);
+        break;
+    case TOTAL_UDISK:
+    case TOTAL_TFCARD:
+    case TOTAL_FLASH:
+        reply(cmd, trackTotal());
+        break;
+    case TRACK_UDISK:
+    case TRACK_TFCARD:
+    case TRACK_FLASH:
+        reply(cmd, track);
+        break;
+    case FOLDER_FILES:
+        reply(FOLDER_FILES, arg >= 1 && arg <= config.folders ? config.filesPerFolder : 0);
+        break;
+    case FOLDER_TOTAL:
+        reply(FOLDER_TOTAL, config.folders);
+        break;
+    default:
+        break;
+    }
+}
+
+void TF16PEmulator::startTrack(const uint16_t number) {
+    track = number;
+    playing = true;
+    paused = false;
+    remainingMs = config.trackMs;
+    trackStartedAt = time_us_64();
+    armFinish(remainingMs);
+}
+
+void TF16PEmulator::stopTrack() {
+    if (finishAlarm > 0) {
+        cancel_alarm(finishAlarm);
+        finishAlarm = 0;
+    }
+    playing = false;
+    paused = false;
+}
+
+void TF16PEmulator::armFinish(const uint32_t ms) {
+    if (finishAlarm > 0) {
+        cancel_alarm(finishAlarm);
+    }
+    finishAlarm = add_alarm_in_us(static_cast<uint64_t>(ms) * 1000, finish, this, true);
+}
+
+int64_t TF16PEmulator::finish(alarm_id_t, void* userData) {
+    auto* self = static_cast<TF16PEmulator*>(userData);
+    critical_section_enter_blocking(&self->lock);
+    self->finishAlarm = 0;
+    self->playing = false;
+    const uint8_t cmd = self->device == 0x01 ? FINISH_UDISK : self->device == 0x02 ? FINISH_TFCARD : FINISH_FLASH;
+    // 与实际模块一致，结束帧连续发送两次
+    self->reply(cmd, self->track);
+    self->reply(cmd, self->track);
+    // 文件夹循环：上报结束后自行播放文件夹内的下一首，末尾回到第一首
+    if (self->loopFolder) {
+        const uint16_t first = (self->loopFolder - 1) * self->config.filesPerFolder + 1;
+        self->startTrack(self->track + 1 < first + self->config.filesPerFolder ? self->track + 1 : first);
+    }
+    critical_section_exit(&self->lock);
+    return 0;
+}
+
+void TF16PEmulator::reply(const uint8_t cmd, const uint16_t arg, const uint32_t delayUs) {
+    Outgoing* out = nullptr;
+    for (Outgoing& candidate : outbox) {
+        bool expected = false;
+        if (candidate.busy.compare_exchange_strong(expected, true)) {
+            out = &candidate;
+            break;
+        }
+    }
+    if (out == nullptr || sink == nullptr) {
+        if (out) {
+            out->busy = false;
+        }
+        return;
+    }
+    out->owner = this;
+    out->frame = makeFrame(cmd, arg, 0x00);
+
+    // 串口不会乱序：送达时间至少晚一帧传输时间，且不早于上一帧结束
+    const uint64_t now = time_us_64();
+    uint64_t due = now + FRAME_US + config.latencyUs + delayUs;
+    if (config.jitterUs) {
+        due += nextRandom() % (config.jitterUs + 1);
+    }
+    if (due < lastDue + FRAME_US) {
+        due = lastDue + FRAME_US;
+    }
+    lastDue = due;
+    if (add_alarm_in_us(due - now, deliver, out, true) <= 0) {
+        out->busy = false;
+    }
+}
+
+int64_t TF16PEmulator::deliver(alarm_id_t, void* userData) {
+    auto* out = static_cast<Outgoing*>(userData);
+    TF16PEmulator* self = out->owner;
+    uint8_t bytes[10];
+    size_t length = 0;
+    critical_section_enter_blocking(&self->lock);
+    if (self->repliesToDrop > 0) {
+        self->repliesToDrop--;
+        self->bytesDropped += sizeof(out->frame.bytes);
+        critical_section_exit(&self->lock);
+        out->busy = false;
+        return 0;
+    }
+    if (self->config.corruptPerMille && self->nextRandom() % 1000 < self->config.corruptPerMille) {
+        out->frame.bytes[5 + self->nextRandom() % 2] ^= 0x5A;
+    }
+    for (const uint8_t byte : out->frame.bytes) {
+        if (self->config.lossPerMille && self->nextRandom() % 1000 < self->config.lossPerMille) {
+            self->bytesDropped++;
+            continue;
+        }
+        bytes[length++] = byte;
+    }
+    self->framesSent++;
+    critical_section_exit(&self->lock);
+    out->busy = false;
+    self->sink(bytes, length, self->sinkArg);
+    return 0;
+}
@@ -0,0 +1,111 @@
+#ifndef TF16P_EMULATOR_H
+#define TF16P_EMULATOR_H
+#include <atomic>
+#include "pico/stdlib.h"
+#include "pico/critical_section.h"
+#include "TF16PParser.h"
+
+// 进程内的TF16P模块模拟器：校验帧、回复应答与查询结果、定时上报曲目结束，
+// 可配置延迟、抖动、丢字节、坏帧和报忙等故障注入。回复帧在闹钟回调（中断上下文）中送达，与串口中断一致
+class TF16PEmulator {
+public:
+    using Sink = void (*)(const uint8_t* data, size_t length, void* arg);
+
+    struct Config {
+        uint32_t latencyUs = 20000; // 收到命令到开始回复的基础延迟
+        uint32_t jitterUs = 5000; // 附加的随机延迟上限
+        uint16_t lossPerMille = 0; // 每个字节的丢失概率（千分比）
+        uint16_t corruptPerMille = 0; // 每个回复帧被改写一个字节的概率，主机侧表现为校验错
+        uint16_t busyPerMille = 0; // 每条命令不执行、直接回复0x40忙（错误码1）的概率
+        uint32_t bootMs = 1500; // 上电/复位到发出0x3F上线帧的时间
+        uint16_t folders = 4;
+        uint16_t filesPerFolder = 10;
+        uint32_t trackMs = 180000; // 每首曲目的播放时长
+        uint32_t seed = 0x2545F491;
+    };
+
+    explicit TF16PEmulator(const Config& config) : config(config), random(config.seed) {
+        critical_section_init(&lock);
+    }
+
+    // 连接到主机侧接收函数，并按 bootMs 发出上线帧
+    void connect(Sink sink, void* arg);
+
+    // 主机发往模块的字节，可分段送入
+    void receive(const uint8_t* data, size_t length);
+
+    // 运行中修改故障注入的概率
+    void setFaults(uint16_t lossPerMille, uint16_t corruptPerMille, uint16_t busyPerMille);
+
+    // 丢弃接下来的 count 个回复帧（整帧不送达），用于确定地制造应答丢失
+    void dropReplies(uint8_t count);
+
+    [[nodiscard]] uint32_t getTrackMs() const {
+        return config.trackMs;
+    }
+
+    [[nodiscard]] uint16_t getVolume() const {
+        return volume;
+    }
+
+    [[nodiscard]] uint32_t getFramesReceived() const {
+        return framesReceived;
+    }
+
+    [[nodiscard]] uint32_t getFramesSent() const {
+        return framesSent;
+    }
+
+    [[nodiscard]] uint32_t getBytesDropped() const {
+        return bytesDropped;
+    }
+
+    [[nodiscard]] uint32_t getChecksumErrors() const {
+        return parser.getChecksumErrors();
+    }
+
+private:
+    static constexpr uint8_t OUTBOX_SIZE = 8;
+    static constexpr uint32_t FRAME_US = 10 * 10 * 1000000 / 9600; // 9600波特率下一帧的传输时间
+
+    struct Outgoing {
+        TF16PEmulator* owner;
+        TF16PFrame frame;
+        std::atomic<bool> busy;
+    };
+
+    Config config;
+    uint32_t random;
+    critical_section_t lock{};
+    TF16PParser parser;
+    Sink sink = nullptr;
+    void* sinkArg = nullptr;
+    Outgoing outbox[OUTBOX_SIZE]{};
+    uint64_t lastDue = 0;
+    alarm_id_t finishAlarm = 0;
+    uint64_t trackStartedAt = 0;
+    uint32_t remainingMs = 0;
+    uint16_t track = 1;
+    uint16_t loopFolder = 0; // 0x17 循环中的文件夹，0 表示不循环
+    uint16_t volume = 30;
+    uint8_t device = 0x02;
+    bool playing = false;
+    bool paused = false;
+    bool sleeping = false;
+    uint32_t framesReceived = 0;
+    uint32_t framesSent = 0;
+    uint32_t bytesDropped = 0;
+    uint8_t repliesToDrop = 0;
+
+    uint32_t nextRandom();
+    void handle(const TF16PFrame& frame);
+    void reply(uint8_t cmd, uint16_t arg, uint32_t delayUs = 0);
+    void startTrack(uint16_t number);
+    void stopTrack();
+    void armFinish(uint32_t ms);
+    [[nodiscard]] uint16_t trackTotal() const;
+    static int64_t deliver(alarm_id_t id, void* userData);
+    static int64_t finish(alarm_id_t id, void* userData);
+};
+
+#endif // TF16P_EMULATOR_H
@@ -0,0 +1,115 @@
+#ifndef TF16P_FRAME_H
+#define TF16P_FRAME_H
+#include <stdint.h>
+#define VOLUME 0x06
+#define PLAY 0x03
+#define RESET 0x0C
+#define NEXT 0x01
+#define PREVIOUS 0x02
+#define VOLUME_UP 0x04
+#define VOLUME_DOWN 0x05
+#define PAUSE 0x0E
+#define RESUME 0x0D
+#define STOP 0x16
+#define PLAY_FOLDER 0x0F
+#define PLAY_LARGE_FOLDER 0x14
+#define LOOP_FOLDER 0x17
+#define STAT 0x42
+#define QUERY_VOLUME 0x43
+#define DEVICE 0x09
+#define STANDBY 0x0A
+#define WAKEUP 0x0B
+#define INIT 0x3F
+#define ERR 0x40
+#define ACK 0x41
+#define TOTAL_UDISK 0x47
+#define TOTAL_TFCARD 0x48
+#define TOTAL_FLASH 0x49
+#define TRACK_UDISK 0x4B
+#define TRACK_TFCARD 0x4C
+#define TRACK_FLASH 0x4D
+#define FOLDER_FILES 0x4E
+#define FOLDER_TOTAL 0x4F
+#define MEDIA_IN 0x3A
+#define MEDIA_OUT 0x3B
+#define FINISH_UDISK 0x3C
+#define FINISH_TFCARD 0x3D
+#define FINISH_FLASH 0x3E
+
+// 模块10字节帧：7E FF 06 CMD FB P1 P2 CK_H CK_L EF
+struct TF16PFrame {
+    uint8_t bytes[10];
+
+    [[nodiscard]] constexpr uint8_t command() const {
+        return bytes[3];
+    }
+
+    [[nodiscard]] constexpr uint16_t argument() const {
+        return bytes[5] << 8 | bytes[6];
+    }
+};
+
+// 0x42~0x4F 为查询命令，模块直接回复同命令字的数据帧
+constexpr bool isQueryCommand(const uint8_t cmd) {
+    return cmd >= 0x42 && cmd <= 0x4F;
+}
+
+// 相对命令重复执行会叠加效果，其余命令重复执行结果不变
+constexpr bool isIdempotent(const uint8_t cmd) {
+    return cmd != NEXT && cmd != PREVIOUS && cmd != VOLUME_UP && cmd != VOLUME_DOWN;
+}
+
+// 0x40 错误码 1 忙、2 休眠中（需先唤醒）、3 串口接收错误、4 校验错误：命令未被执行，可以原样重发
+constexpr bool isTransientError(const uint16_t code) {
+    return code >= 0x01 && code <= 0x04;
+}
+
+// 校验和为 VER..P2 六个字节之和取负
+constexpr uint16_t frameChecksum(const uint8_t cmd, const uint8_t feedback, const uint16_t arg) {
+    return static_cast<uint16_t>(0 - (0xFF + 0x06 + cmd + feedback + (arg >> 8) + (arg & 0xFF)));
+}
+
+// 控制命令请求0x41应答；查询命令本身会回复数据帧，不请求应答
+constexpr TF16PFrame makeFrame(const uint8_t cmd, const uint16_t arg = 0,
+                               const uint8_t feedback = 0xFF) {
+    const uint8_t fb = feedback == 0xFF ? (isQueryCommand(cmd) ? 0x00 : 0x01) : feedback;
+    const uint16_t checksum = frameChecksum(cmd, fb, arg);
+    return TF16PFrame{{
+        0x7E, 0xFF, 0x06, cmd, fb,
+        static_cast<uint8_t>(arg >> 8), static_cast<uint8_t>(arg & 0xFF),
+        static_cast<uint8_t>(checksum >> 8), static_cast<uint8_t>(checksum & 0xFF), 0xEF
+    }};
+}
+
+// 只改写参数字节，并按新旧参数字节和之差修正校验和
+inline void patchArgument(TF16PFrame& frame, const uint16_t arg) {
+    const uint8_t high = arg >> 8;
+    const uint8_t low = arg & 0xFF;
+    const uint16_t checksum = (frame.bytes[7] << 8 | frame.bytes[8]) + frame.bytes[5] + frame.bytes[6] - high - low;
+    frame.bytes[5] = high;
+    frame.bytes[6] = low;
+    frame.bytes[7] = checksum >> 8;
+    frame.bytes[8] = checksum & 0xFF;
+}
+
+// 固定命令帧，校验和在编译期算好
+namespace TF16PFrames {
+constexpr TF16PFrame STOP_FRAME = makeFrame(STOP);
+constexpr TF16PFrame PAUSE_FRAME = makeFrame(PAUSE);
+constexpr TF16PFrame RESUME_FRAME = makeFrame(RESUME);
+constexpr TF16PFrame STAT_FRAME = makeFrame(STAT);
+constexpr TF16PFrame SELECT_UDISK = makeFrame(DEVICE, 0x01);
+constexpr TF16PFrame SELECT_TFCARD = makeFrame(DEVICE, 0x02);
+constexpr TF16PFrame SELECT_FLASH = makeFrame(DEVICE, 0x04);
+constexpr TF16PFrame STANDBY_FRAME = makeFrame(STANDBY);
+constexpr TF16PFrame WAKEUP_FRAME = makeFrame(WAKEUP);
+// 不请求应答的唤醒帧，在处理休眠错误时直接插到重发命令之前
+constexpr TF16PFrame WAKEUP_QUIET = makeFrame(WAKEUP, 0, 0x00);
+// 带参数命令的模板，发送前用 patchArgument() 填入参数
+constexpr TF16PFrame PLAY_TEMPLATE = makeFrame(PLAY);
+constexpr TF16PFrame VOLUME_TEMPLATE = makeFrame(VOLUME);
+
+static_assert(STOP_FRAME.bytes[7] == 0xFE && STOP_FRAME.bytes[8] == 0xE4, "checksum of 7E FF 06 16 01 00 00");
+}
+
+#endif // TF16P_FRAME_H
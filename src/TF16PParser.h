@@ -0,0 +1,92 @@
+#ifndef TF16P_PARSER_H
+#define TF16P_PARSER_H
+#include <stdint.h>
+#include <string.h>
+#include "TF16PFrame.h"
+
+// 逐字节的增量帧解析器，不依赖硬件，可直接在中断中调用
+class TF16PParser {
+    TF16PFrame current{};
+    uint8_t length = 0;
+    uint32_t checksumErrors = 0;
+    uint32_t discardedBytes = 0;
+
+    [[nodiscard]] bool checksumValid() const {
+        uint16_t sum = 0;
+        for (int i = 1; i < 7; i++) {
+            sum += current.bytes[i];
+        }
+        return static_cast<uint16_t>(sum + (current.bytes[7] << 8 | current.bytes[8])) == 0;
+    }
+
+    // 当前帧失败时丢弃起始字节，把已收到部分中的下一个0x7E移到开头，再检查它之后已收到的帧头字节。
+    // 就地移动而不是把字节重新送入 push()：中断里没有递归，失败的帧中任意位置的0x7E都会被当作帧头再试一次。
+    // 移动后最多剩9字节，不会在这里凑成完整帧
+    void resync() {
+        uint8_t start = 1;
+        while (true) {
+            while (start < length && current.bytes[start] != 0x7E) {
+                start++;
+            }
+            discardedBytes += start;
+            length -= start;
+            memmove(current.bytes, current.bytes + start, length);
+            if ((length >= 2 && current.bytes[1] != 0xFF) || (length >= 3 && current.bytes[2] != 0x06)) {
+                start = 1;
+                continue;
+            }
+            return;
+        }
+    }
+
+public:
+    // 返回 true 表示 frame() 中已有一帧校验通过的完整帧
+    bool push(const uint8_t byte) {
+        if (length == 0 && byte != 0x7E) {
+            discardedBytes++;
+            return false;
+        }
+        current.bytes[length++] = byte;
+        switch (length) {
+        case 2:
+            if (byte != 0xFF) {
+                resync();
+            }
+            break;
+        case 3:
+            if (byte != 0x06) {
+                resync();
+            }
+            break;
+        case 10:
+            if (byte != 0xEF) {
+                resync();
+                return false;
+            }
+            if (!checksumValid()) {
+                checksumErrors++;
+                resync();
+                return false;
+            }
+            length = 0;
+            return true;
+        default:
+            break;
+        }
+        return false;
+    }
+
+    [[nodiscard]] const TF16PFrame& frame() const {
+        return current;
+    }
+
+    [[nodiscard]] uint32_t getChecksumErrors() const {
+        return checksumErrors;
+    }
+
+    [[nodiscard]] uint32_t getDiscardedBytes() const {
+        return discardedBytes;
+    }
+};
+
+#endif // TF16P_PARSER_H
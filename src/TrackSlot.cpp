@@ -0,0 +1,220 @@
+#include "TrackSlot.h"
+
+bool TrackSlot::open(const char* path) {
+    close();
+    strncpy(this->path, path, StartCache::PATH_LENGTH - 1);
+    this->path[StartCache::PATH_LENGTH - 1] = '\0';
+    format = formatOf(path);
+    if (!reader.open(path)) {
+        return false;
+    }
+    opened = true;
+    if (!startDecoder()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool TrackSlot::startDecoder() {
+    if (format == AudioFormat::FLAC) {
+        if (!flac.start(reader, writeFromFlac, this)) {
+            return false;
+        }
+        const uint64_t durationMs = flac.getSampleRate() ? flac.getTotalSamples() * 1000 / flac.getSampleRate() : 0;
+        flacKbps = durationMs ? static_cast<uint16_t>(static_cast<uint64_t>(reader.size()) * 8 / durationMs) : 0;
+    } else if (format == AudioFormat::VORBIS) {
+        // 另一首仍在解码时不能动 VorbisArena
+        if (vorbis.isActive()) {
+            vorbisPending = true;
+            return true;
+        }
+        if (!vorbis.start(reader)) {
+            return false;
+        }
+        ownsVorbis = true;
+    } else {
+        mp3.start(reader);
+        seekIndex.begin(reader, path);
+    }
+    return true;
+}
+
+bool TrackSlot::resume(const StartCache::Entry& entry) {
+    close();
+    memcpy(path, entry.path, StartCache::PATH_LENGTH);
+    format = entry.format;
+    // 整首都在缓存中时不打开文件，下一次解码即到达末尾
+    if (entry.complete) {
+        opened = true;
+        return true;
+    }
+    if (!reader.open(entry.path)) {
+        return false;
+    }
+    opened = true;
+    if (format == AudioFormat::FLAC) {
+        if (!flac.start(reader, writeFromFlac, this)) {
+            close();
+            return false;
+        }
+        seekPending = true;
+        resumeSample = entry.resumeSample;
+        return true;
+    }
+    // 沿帧头走到恢复起点，顺带把缓存覆盖的部分记入索引；索引不可用时直接跳到记下的位置
+    mp3.start(reader);
+    seekIndex.begin(reader, entry.path);
+    uint32_t landed = 0;
+    if (!seekIndex.seek(reader, entry.resumeFrame, landed)) {
+        reader.seek(entry.resumeOffset);
+    }
+    mp3.restart(entry.resumeFrame);
+    // 缓存最后一帧及之前的预热帧只用于恢复解码状态；若最后一帧因比特池不足被跳过，
+    // 解出的已是缓存之后的第一帧，留到 decode() 输出
+    while (true) {
+        const uint32_t samples = mp3.decode(reader);
+        if (samples == 0) {
+            close();
+            return false;
+        }
+        if (mp3.getFrameOffset() < entry.lastOffset) {
+            continue;
+        }
+        if (mp3.getFrameOffset() > entry.lastOffset) {
+            heldSamples = samples;
+        }
+        return true;
+    }
+}
+
+bool TrackSlot::activate() {
+    if (vorbisPending) {
+        vorbisPending = false;
+        if (!vorbis.start(reader)) {
+            return false;
+        }
+        ownsVorbis = true;
+    }
+    if (seekPending) {
+        seekPending = false;
+        return flac.seek(resumeSample);
+    }
+    return true;
+}
+
+uint32_t TrackSlot::decode() {
+    if (!reader.isOpen()) {
+        return 0;
+    }
+    if (format == AudioFormat::FLAC) {
+        // FLAC 帧在写回调中按块输出
+        return flac.decode();
+    }
+    if (format == AudioFormat::VORBIS) {
+        const uint32_t samples = vorbis.decode();
+        if (samples) {
+            sink(vorbis.pcm(), samples, vorbis.getChannels(), sinkArg);
+        }
+        return samples;
+    }
+    if (heldSamples) {
+        const uint32_t samples = heldSamples;
+        heldSamples = 0;
+        sink(mp3.pcm(), samples, mp3.getChannels(), sinkArg);
+        return samples;
+    }
+    const uint32_t samples = mp3.decode(reader);
+    // 到了末尾填充时 decode() 返回0，被裁掉的帧也记入索引
+    seekIndex.record(mp3.getFrameNumber(), mp3.getFrameOffset());
+    if (samples == 0) {
+        seekIndex.finish(reader, mp3.getFrameNumber());
+    } else {
+        sink(mp3.pcm(), samples, mp3.getChannels(), sinkArg);
+    }
+    return samples;
+}
+
+bool TrackSlot::seek(const uint32_t positionMs) {
+    heldSamples = 0;
+    if (format == AudioFormat::FLAC) {
+        // 定位时该帧从目标样本起的部分直接经写回调输出
+        return flac.seek(static_cast<uint64_t>(positionMs) * flac.getSampleRate() / 1000);
+    }
+    if (format == AudioFormat::VORBIS) {
+        return vorbis.seek(positionMs);
+    }
+    return seekMp3(positionMs);
+}
+
+// 从目标帧之前 WARMUP_FRAMES 帧处开始解码，预热帧的输出丢弃，只用于恢复比特池和 IMDCT 重叠状态
+bool TrackSlot::seekMp3(const uint32_t positionMs) {
+    const uint32_t frame = mp3.frameOf(static_cast<uint64_t>(positionMs) * seekIndex.getSampleRate() / 1000,
+                                       seekIndex.getSamplesPerFrame());
+    const uint32_t warmup = frame > StartCache::WARMUP_FRAMES ? StartCache::WARMUP_FRAMES : frame;
+    uint32_t landed = 0;
+    if (!seekIndex.seek(reader, frame - warmup, landed)) {
+        return false;
+    }
+    mp3.restart(landed);
+    while (true) {
+        const uint32_t samples = mp3.decode(reader);
+        if (samples == 0) {
+            return false;
+        }
+        seekIndex.record(mp3.getFrameNumber(), mp3.getFrameOffset());
+        if (mp3.getFrameNumber() >= landed + warmup) {
+            sink(mp3.pcm(), samples, mp3.getChannels(), sinkArg);
+            return true;
+        }
+    }
+}
+
+bool TrackSlot::extendIndex(FileReader& other, const uint16_t frames) {
+    return opened && format == AudioFormat::MP3 && seekIndex.extend(other, frames);
+}
+
+uint32_t TrackSlot::remainingMs() const {
+    if (!reader.isOpen()) {
+        return 0;
+    }
+    const uint16_t kbps = getBitrateKbps() ? getBitrateKbps() : flacKbps;
+    if (kbps == 0) {
+        return UINT32_MAX;
+    }
+    return static_cast<uint32_t>(static_cast<uint64_t>(reader.size() - reader.tell()) * 8 / kbps);
+}
+
+void TrackSlot::close() {
+    flac.finish();
+    if (ownsVorbis) {
+        vorbis.finish();
+        ownsVorbis = false;
+    }
+    reader.close();
+    seekIndex.close();
+    opened = false;
+    vorbisPending = false;
+    seekPending = false;
+    heldSamples = 0;
+    flacKbps = 0;
+}
+
+uint32_t TrackSlot::getSampleRate() const {
+    if (format == AudioFormat::FLAC) {
+        return flac.getSampleRate();
+    }
+    return format == AudioFormat::VORBIS ? vorbis.getSampleRate() : mp3.getSampleRate();
+}
+
+uint16_t TrackSlot::getBitrateKbps() const {
+    if (format == AudioFormat::FLAC) {
+        return 0;
+    }
+    return format == AudioFormat::VORBIS ? vorbis.getBitrateKbps() : mp3.getBitrateKbps();
+}
+
+void TrackSlot::writeFromFlac(const int16_t* samples, const uint32_t frames, void* arg) {
+    auto* self = static_cast<TrackSlot*>(arg);
+    self->sink(samples, frames, 2, self->sinkArg);
+}
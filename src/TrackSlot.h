@@ -0,0 +1,89 @@
+#ifndef TRACK_SLOT_H
+#define TRACK_SLOT_H
+#include <stdint.h>
+#include "AudioFormat.h"
+#include "FileReader.h"
+#include "Mp3Decoder.h"
+#include "FlacDecoder.h"
+#include "VorbisDecoder.h"
+#include "SeekIndex.h"
+#include "StartCache.h"
+
+// 一首曲目的文件读取器、解码器与定位索引（约37KB）。管线持有两个：正在播放的一首，以及连续播放时
+// 在当前曲目末尾前预先打开的下一首，衔接时只交换两者，打开文件、解析文件头与恢复解码状态都不在曲目交界处进行。
+// 预先打开的一首在 activate() 之前不经 Sink 输出任何样本。
+// Vorbis 解码器独占 VorbisArena，两个槽位共用一个：另一首正在用它时只打开文件，到 activate() 时再解析 Vorbis 头
+class TrackSlot {
+public:
+    // 交织的16位样本，channels 为1或2
+    using Sink = void (*)(const int16_t* samples, uint32_t frames, uint8_t channels, void* arg);
+
+    TrackSlot(VorbisDecoder& vorbis, const Sink sink, void* arg) : vorbis(vorbis), sink(sink), sinkArg(arg) {
+    }
+
+    // 打开曲目并解析到第一个音频帧之前，失败时返回 false
+    bool open(const char* path);
+
+    // 打开启动缓存中的曲目并把解码器恢复到缓存末尾（缓存的样本由调用者写出）。
+    // MP3 在此完成预热解码，已解出的缓存之后的第一帧在下一次 decode() 时输出；FLAC 的定位留到 activate()
+    bool resume(const StartCache::Entry& entry);
+
+    // 成为正在播放的一首：完成推迟的 Vorbis 头解析与 FLAC 定位（定位所在帧的剩余部分立即经 Sink 输出）
+    bool activate();
+
+    // 解出下一帧经 Sink 输出，返回每声道样本数；0 表示文件结束或出错
+    uint32_t decode();
+
+    // 当前格式支持定位（MP3 需要可用的索引）
+    [[nodiscard]] bool isSeekable() const {
+        return format != AudioFormat::MP3 || seekIndex.isUsable();
+    }
+
+    // 跳到第 positionMs 毫秒，新位置的第一段样本立即经 Sink 输出；失败时返回 false
+    bool seek(uint32_t positionMs);
+
+    // 后台索引：在另一个 reader 上扫描本曲目的 MP3 帧头，见 SeekIndex::extend()
+    bool extendIndex(FileReader& other, uint16_t frames);
+
+    // 按文件中未读取的字节数与码率估计的剩余时长，码率未知时返回 UINT32_MAX
+    [[nodiscard]] uint32_t remainingMs() const;
+
+    void close();
+
+    [[nodiscard]] bool isOpen() const {
+        return opened;
+    }
+
+    [[nodiscard]] AudioFormat getFormat() const {
+        return format;
+    }
+
+    [[nodiscard]] uint32_t getSampleRate() const;
+
+    // FLAC 为0
+    [[nodiscard]] uint16_t getBitrateKbps() const;
+
+private:
+    FileReader reader;
+    Mp3Decoder mp3;
+    FlacDecoder flac;
+    SeekIndex seekIndex;
+    VorbisDecoder& vorbis;
+    Sink sink;
+    void* sinkArg;
+    AudioFormat format = AudioFormat::MP3;
+    char path[StartCache::PATH_LENGTH]{};
+    bool opened = false;
+    bool ownsVorbis = false;
+    bool vorbisPending = false;  // 文件已打开，Vorbis 头留到 activate() 解析
+    bool seekPending = false;    // FLAC：activate() 时定位到 resumeSample
+    uint64_t resumeSample = 0;
+    uint32_t heldSamples = 0;    // MP3：恢复时已解出、尚未输出的一帧
+    uint16_t flacKbps = 0;       // FLAC 的平均码率，只用于估计剩余时长
+
+    bool startDecoder();
+    bool seekMp3(uint32_t positionMs);
+    static void writeFromFlac(const int16_t* samples, uint32_t frames, void* arg);
+};
+
+#endif // TRACK_SLOT_H
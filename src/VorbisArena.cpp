@@ -0,0 +1,128 @@
+#include "VorbisArena.h"
+#include <string.h>
+
+// 每块前有8字节块头，块大小含块头且按8字节对齐；空闲的相邻块在下一次分配遍历时合并
+struct Block {
+    uint32_t size;
+    uint32_t free;
+};
+
+static constexpr uint32_t ALIGN = 8;
+alignas(ALIGN) static uint8_t arena[VorbisArena::SIZE];
+static size_t used = 0;
+static size_t peak = 0;
+static bool initialized = false;
+
+static Block* blockAt(const size_t offset) {
+    return reinterpret_cast<Block*>(arena + offset);
+}
+
+static Block* headerOf(void* pointer) {
+    return static_cast<Block*>(pointer) - 1;
+}
+
+static uint32_t blockSize(const size_t size) {
+    return static_cast<uint32_t>((size + sizeof(Block) + ALIGN - 1) & ~static_cast<size_t>(ALIGN - 1));
+}
+
+// 剩余部分足够放下一个最小块时把 block 截成 size，余下的作为空闲块
+static void split(Block* block, const uint32_t size) {
+    if (block->size - size < sizeof(Block) + ALIGN) {
+        return;
+    }
+    Block* rest = reinterpret_cast<Block*>(reinterpret_cast<uint8_t*>(block) + size);
+    rest->size = block->size - size;
+    rest->free = 1;
+    block->size = size;
+}
+
+static Block* next(Block* block) {
+    uint8_t* end = reinterpret_cast<uint8_t*>(block) + block->size;
+    return end < arena + VorbisArena::SIZE ? reinterpret_cast<Block*>(end) : nullptr;
+}
+
+void VorbisArena::reset() {
+    Block* first = blockAt(0);
+    first->size = SIZE;
+    first->free = 1;
+    used = 0;
+    initialized = true;
+}
+
+size_t VorbisArena::getUsed() {
+    return used;
+}
+
+size_t VorbisArena::getPeak() {
+    return peak;
+}
+
+void* vorbis_arena_malloc(const size_t size) {
+    if (!initialized) {
+        VorbisArena::reset();
+    }
+    const uint32_t wanted = blockSize(size);
+    for (Block* block = blockAt(0); block != nullptr; block = next(block)) {
+        if (!block->free) {
+            continue;
+        }
+        for (Block* after = next(block); after != nullptr && after->free; after = next(block)) {
+            block->size += after->size;
+        }
+        if (block->size >= wanted) {
+            split(block, wanted);
+            block->free = 0;
+            used += block->size;
+            peak = used > peak ? used : peak;
+            return block + 1;
+        }
+    }
+    return nullptr;
+}
+
+void* vorbis_arena_calloc(const size_t count, const size_t size) {
+    void* pointer = vorbis_arena_malloc(count * size);
+    if (pointer) {
+        memset(pointer, 0, count * size);
+    }
+    return pointer;
+}
+
+// 原块或与其后的空闲块合并后放得下时原地调整，否则另行分配并复制
+void* vorbis_arena_realloc(void* pointer, const size_t size) {
+    if (pointer == nullptr) {
+        return vorbis_arena_malloc(size);
+    }
+    if (size == 0) {
+        vorbis_arena_free(pointer);
+        return nullptr;
+    }
+    Block* block = headerOf(pointer);
+    const uint32_t wanted = blockSize(size);
+    used -= block->size;
+    for (Block* after = next(block); block->size < wanted && after != nullptr && after->free; after = next(block)) {
+        block->size += after->size;
+    }
+    if (block->size >= wanted) {
+        split(block, wanted);
+        used += block->size;
+        peak = used > peak ? used : peak;
+        return pointer;
+    }
+    used += block->size;
+    void* moved = vorbis_arena_malloc(size);
+    if (moved) {
+        memcpy(moved, pointer, block->size - sizeof(Block));
+        vorbis_arena_free(pointer);
+    }
+    return moved;
+}
+
+void vorbis_arena_free(void* pointer) {
+    if (pointer == nullptr) {
+        return;
+    }
+    Block* block = headerOf(pointer);
+    block->free = 1;
+    used -= block->size;
+}
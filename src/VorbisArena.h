@@ -0,0 +1,28 @@
+#ifndef VORBIS_ARENA_H
+#define VORBIS_ARENA_H
+#include <stdint.h>
+#include <stddef.h>
+
+// Tremor 与 libogg 的全部堆分配都重定向到这里（见 lib/CMakeLists.txt 中的 malloc 重映射），
+// 从固定大小的静态区域中首次适配分配，不占用 FreeRTOS 堆；用尽时返回 NULL，打开文件随之失败。
+// 只有解码任务使用，不加锁
+class VorbisArena {
+public:
+    // 44.1kHz 立体声、常见码率下 Tremor 的峰值约为 60~90KB，实际值见 AudioStats 的 arena peak
+    static constexpr size_t SIZE = 128 * 1024;
+
+    // 丢弃全部分配（ov_clear 之后调用，防止泄漏累积）
+    static void reset();
+
+    [[nodiscard]] static size_t getUsed();
+    [[nodiscard]] static size_t getPeak();
+};
+
+extern "C" {
+void* vorbis_arena_malloc(size_t size);
+void* vorbis_arena_calloc(size_t count, size_t size);
+void* vorbis_arena_realloc(void* pointer, size_t size);
+void vorbis_arena_free(void* pointer);
+}
+
+#endif // VORBIS_ARENA_H
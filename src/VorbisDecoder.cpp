@@ -0,0 +1,94 @@
+#include "VorbisDecoder.h"
+#include <stdio.h>
+#include "VorbisArena.h"
+
+VorbisDecoder::~VorbisDecoder() {
+    finish();
+}
+
+bool VorbisDecoder::start(FileReader& reader) {
+    finish();
+    this->reader = &reader;
+    section = -1;
+    // 文件由管线关闭，不提供 close 回调
+    const ov_callbacks callbacks{readCallback, seekCallback, nullptr, tellCallback};
+    if (ov_open_callbacks(this, &file, nullptr, 0, callbacks) != 0) {
+        // 打开失败时 Tremor 已释放自己的结构，剩余的分配一并丢弃
+        VorbisArena::reset();
+        return false;
+    }
+    active = true;
+    readInfo();
+    if (sampleRate == 0 || channels == 0) {
+        finish();
+        return false;
+    }
+    return true;
+}
+
+uint32_t VorbisDecoder::decode() {
+    if (!active) {
+        return 0;
+    }
+    // ov_read 会填满给出的长度：单声道时整个缓冲区是 2 * MAX_FRAMES 帧，按声道数限制为 MAX_FRAMES 帧
+    const size_t frameBytes = sizeof(int16_t) * channels;
+    const size_t limit = MAX_FRAMES * frameBytes < sizeof(samples) ? MAX_FRAMES * frameBytes : sizeof(samples);
+    while (true) {
+        int current = 0;
+        const long bytes = ov_read(&file, reinterpret_cast<char*>(samples), static_cast<int>(limit), &current);
+        // OV_HOLE 为数据中断（如坏页），跳过后继续；其余负值为不可恢复的错误
+        if (bytes == OV_HOLE) {
+            continue;
+        }
+        if (bytes <= 0) {
+            return 0;
+        }
+        if (current != section) {
+            section = current;
+            readInfo();
+        }
+        return static_cast<uint32_t>(bytes) / (2 * channels);
+    }
+}
+
+bool VorbisDecoder::seek(const uint32_t positionMs) {
+    return active && ov_time_seek(&file, positionMs) == 0;
+}
+
+void VorbisDecoder::finish() {
+    if (active) {
+        ov_clear(&file);
+        VorbisArena::reset();
+        active = false;
+    }
+}
+
+void VorbisDecoder::readInfo() {
+    const vorbis_info* info = ov_info(&file, -1);
+    sampleRate = info ? static_cast<uint32_t>(info->rate) : 0;
+    channels = info ? static_cast<uint8_t>(info->channels) : 0;
+    const long bitrate = ov_bitrate(&file, -1);
+    bitrateKbps = bitrate > 0 ? static_cast<uint16_t>(bitrate / 1000) : 0;
+}
+
+size_t VorbisDecoder::readCallback(void* pointer, const size_t size, const size_t count, void* source) {
+    if (size == 0) {
+        return 0;
+    }
+    return static_cast<VorbisDecoder*>(source)->reader->read(static_cast<uint8_t*>(pointer), size * count) / size;
+}
+
+int VorbisDecoder::seekCallback(void* source, const ogg_int64_t offset, const int whence) {
+    FileReader* reader = static_cast<VorbisDecoder*>(source)->reader;
+    ogg_int64_t target = offset;
+    if (whence == SEEK_CUR) {
+        target += reader->tell();
+    } else if (whence == SEEK_END) {
+        target += reader->size();
+    }
+    return target >= 0 && reader->seek(static_cast<uint32_t>(target)) ? 0 : -1;
+}
+
+long VorbisDecoder::tellCallback(void* source) {
+    return static_cast<long>(static_cast<VorbisDecoder*>(source)->reader->tell());
+}
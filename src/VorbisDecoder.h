@@ -0,0 +1,64 @@
+#ifndef VORBIS_DECODER_H
+#define VORBIS_DECODER_H
+#include <stdint.h>
+#include "ivorbisfile.h"
+#include "FileReader.h"
+
+// Tremor 定点 Ogg Vorbis 解码：只用整数运算，不占用 FPU；数据经 FileReader 读取，
+// 堆分配全部来自 VorbisArena 的静态区域，每次输出一段交织的16位样本
+class VorbisDecoder {
+public:
+    // 每次最多输出的帧数（单声道与立体声相同），小于一个 MP3 帧，管线为 MP3 预留的环空间同样够用
+    static constexpr uint16_t MAX_FRAMES = 1024;
+
+    ~VorbisDecoder();
+
+    // 解析 Ogg 头和三个 Vorbis 头包，失败（含静态区域不足）时返回 false
+    bool start(FileReader& reader);
+
+    // 解出下一段样本，返回每声道样本数；0 表示文件结束或出错
+    uint32_t decode();
+
+    // 跳到第 positionMs 毫秒（Tremor 的时间单位为毫秒），按 Ogg 页的粒度位置二分查找
+    bool seek(uint32_t positionMs);
+
+    void finish();
+
+    // 已打开一个流，VorbisArena 正被占用
+    [[nodiscard]] bool isActive() const {
+        return active;
+    }
+
+    [[nodiscard]] const int16_t* pcm() const {
+        return samples;
+    }
+
+    [[nodiscard]] uint8_t getChannels() const {
+        return channels;
+    }
+
+    [[nodiscard]] uint32_t getSampleRate() const {
+        return sampleRate;
+    }
+
+    [[nodiscard]] uint16_t getBitrateKbps() const {
+        return bitrateKbps;
+    }
+
+private:
+    OggVorbis_File file{};
+    FileReader* reader = nullptr;
+    int section = -1; // 当前逻辑流，串联的 Ogg 文件换流时重新读取格式
+    uint32_t sampleRate = 0;
+    uint8_t channels = 0;
+    uint16_t bitrateKbps = 0;
+    bool active = false;
+    int16_t samples[MAX_FRAMES * 2]{};
+
+    void readInfo();
+    static size_t readCallback(void* pointer, size_t size, size_t count, void* source);
+    static int seekCallback(void* source, ogg_int64_t offset, int whence);
+    static long tellCallback(void* source);
+};
+
+#endif // VORBIS_DECODER_H
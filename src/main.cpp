@@ -6,30 +6,115 @@
 #include "timers.h"
 #include "pico/stdlib.h"
 #include "PlayerTF16P.h"
+#include "PlayerCommand.h"
 #include "../lib/OLED-UI/OLED_UI.h"
 #include "../lib/OLED-UI/OLED_UI_MenuData.h"
 #include "public.h"
-#include "stream_decoder.h"
+#if PLAYER_TF16P_EMULATOR
+#include "TF16PEmulator.h"
+#endif
+#if PLAYER_SOFTWARE_DECODE
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include "AudioPipeline.h"
+#endif
 
 // extern "C" void vLaunch(void);
-// 播放器全局对象
-PlayerTF16P player(4, 5, uart1);
-
-// 同步机制
-SemaphoreHandle_t playerMutex; // 互斥锁
-QueueHandle_t playerCommandQueue; // 命令队列
-
-// 播放器控制命令枚举
-enum PlayerCommand {
-    CMD_PLAY,
-    CMD_PAUSE,
-    CMD_STOP,
-    CMD_NEXT,
-    CMD_PREV,
-    CMD_VOL_UP,
-    CMD_VOL_DOWN
+// 播放区：每个区一个模块实例，拥有独立的命令队列、互斥锁和播放器任务
+struct PlayerZone {
+    const char* name;
+    PlayerTF16P player;
+    DeviceType device;
+    UBaseType_t core; // 播放器任务绑定的核心
+    SemaphoreHandle_t mutex;
+    QueueHandle_t commands;
+    TaskHandle_t task;
+    // 合并连续按键产生的命令，链路空闲时一次性下发
+    CommandCoalescer coalescer;
 };
 
+#if PLAYER_SECOND_ZONE
+constexpr int ZONE_COUNT = 2;
+#else
+constexpr int ZONE_COUNT = 1;
+#endif
+
+PlayerZone zones[ZONE_COUNT] = {
+    {"PLAYER", PlayerTF16P(4, 5, uart1), DeviceType::TFCARD, 1, nullptr, nullptr, nullptr, {}},
+#if PLAYER_SECOND_ZONE
+    // 第二个模块接uart0（GP0/GP1），此时标准输入输出改走USB
+    {"PLAYER2", PlayerTF16P(0, 1, uart0), DeviceType::TFCARD, 0, nullptr, nullptr, nullptr, {}},
+#endif
+};
+
+#if PLAYER_TF16P_EMULATOR
+// 无模块时用模拟器代替各区串口上的TF16P
+TF16PEmulator emulators[ZONE_COUNT] = {
+    TF16PEmulator{TF16PEmulator::Config{}},
+#if PLAYER_SECOND_ZONE
+    TF16PEmulator{TF16PEmulator::Config{}},
+#endif
+};
+#endif
+
+#if PLAYER_SOFTWARE_DECODE
+// 片内解码输出：I2S 数据 GP9，BCLK GP10，LRCLK GP11
+AudioPipeline pipeline(pio0, 9, 10);
+FATFS filesystem;
+
+// 软件解码的曲目表：卡根目录下按目录顺序排列的音频文件（8.3 文件名），启动时在解码任务创建前扫描一次，
+// 之后只有解码任务访问 FatFs
+constexpr uint16_t SOFTWARE_TRACKS = 128;
+char trackNames[SOFTWARE_TRACKS][13];
+uint16_t trackCount = 0;
+uint16_t currentTrack = 0;
+uint32_t seenTrackChanges = 0;
+
+void scanTracks() {
+    DIR dir;
+    FILINFO info;
+    if (f_opendir(&dir, "/") != FR_OK) {
+        return;
+    }
+    while (trackCount < SOFTWARE_TRACKS && f_readdir(&dir, &info) == FR_OK && info.fname[0]) {
+        const char* extension = strrchr(info.fname, '.');
+        if (info.fattrib & (AM_DIR | AM_HID | AM_SYS) || !extension) {
+            continue;
+        }
+        if (strcasecmp(extension, ".MP3") == 0 || strcasecmp(extension, ".FLA") == 0 ||
+            strcasecmp(extension, ".OGG") == 0) {
+            strcpy(trackNames[trackCount++], info.fname);
+        }
+    }
+    f_closedir(&dir);
+}
+
+void trackPath(const uint16_t track, char* path) {
+    snprintf(path, AudioPipeline::PATH_LENGTH, "/%s", trackNames[track % trackCount]);
+}
+
+// 让管线预解码当前曲目前后两首的开头；连续播放时下一首由此接上
+void updateNeighbours() {
+    char next[AudioPipeline::PATH_LENGTH];
+    char previous[AudioPipeline::PATH_LENGTH];
+    trackPath(currentTrack + 1, next);
+    trackPath(currentTrack + trackCount - 1, previous);
+    pipeline.setNeighbours(next, previous);
+}
+
+void playSoftwareTrack(const uint16_t track) {
+    if (trackCount == 0) {
+        return;
+    }
+    char path[AudioPipeline::PATH_LENGTH];
+    currentTrack = track % trackCount;
+    trackPath(currentTrack, path);
+    pipeline.play(path);
+    updateNeighbours();
+}
+#endif
+
 void openLED(void* pvParameters) {
     constexpr uint LED_PIN = PICO_DEFAULT_LED_PIN;
     gpio_init(LED_PIN);
@@ -38,71 +123,135 @@ void openLED(void* pvParameters) {
     vTaskDelete(nullptr); // 任务完成后删除自身
 }
 
+// 发送播放命令并唤醒对应播放区的任务
+void sendPlayerCommand(PlayerZone& zone, const PlayerCommand cmd) {
+    if (xQueueSend(zone.commands, &cmd, 0)) {
+        xTaskNotifyGive(zone.task);
+    }
+}
+
+// 模块主动上报的事件，在播放器任务的 process() 中回调（已持有该区的互斥锁）
+void onPlayerEvent(const PlayerEvent& event, void* arg) {
+    PlayerTF16P& player = static_cast<PlayerZone*>(arg)->player;
+    switch (event.type) {
+    case PlayerEventType::TRACK_FINISHED:
+        // 连播未能在中断中切歌时（如链路正忙），由任务按同样的顺序补发下一曲；文件夹循环时不会收到此事件
+        player.playNext();
+        break;
+    case PlayerEventType::TRACK_ADVANCED:
+        break;
+    case PlayerEventType::MEDIA_INSERTED:
+        // 重新选择存储设备，曲目总数等缓存随后自动补齐
+        player.selectDevice(event.device);
+        break;
+    case PlayerEventType::MEDIA_REMOVED:
+        break;
+    case PlayerEventType::MODULE_ERROR:
+        // 重发与错误后的状态重新同步由驱动自行完成
+        break;
+    }
+}
+
+// 串口中断收到完整帧后唤醒播放器任务
+void notifyPlayerFromIsr(void* arg) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(static_cast<TaskHandle_t>(arg), &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
 [[noreturn]] void playerTask(void* pvParameters) {
+    PlayerZone& zone = *static_cast<PlayerZone*>(pvParameters);
+    PlayerTF16P& player = zone.player;
+
     // 初始化播放器
-    player.begin(DeviceType::TFCARD);
+    player.setNotify(notifyPlayerFromIsr, xTaskGetCurrentTaskHandle());
+    player.setEventHandler(onPlayerEvent, &zone);
+#if PLAYER_TF16P_EMULATOR
+    player.attach(emulators[&zone - zones]);
+    // 模拟器的曲目时长固定
+    player.setDurationSource([](DeviceType, uint16_t, void* arg) {
+        return static_cast<TF16PEmulator*>(arg)->getTrackMs();
+    }, &emulators[&zone - zones]);
+#endif
+    // 不等待模块上电，模块上线后由 process() 发出设备选择；其他任务的初始化同时进行
+    player.begin(zone.device);
+    player.setSequencing(true);
+    player.setStandby(PlayerTF16P::STANDBY_IDLE_MS);
 
     PlayerCommand cmd;
     while (true) {
-        // 等待控制命令（带超时）
-        if (xQueueReceive(playerCommandQueue, &cmd, pdMS_TO_TICKS(10))) {
+        // 等待新命令、模块帧（均通过任务通知）或在途命令超时，空闲时无限期阻塞
+        const uint32_t wait = player.msUntilDeadline();
+        ulTaskNotifyTake(pdTRUE, wait == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(wait));
+
+        while (xQueueReceive(zone.commands, &cmd, 0)) {
+            zone.coalescer.add(cmd);
+        }
+
+        // 链路忙时继续累积按键，待上一帧完成后再合并下发
+        if (!zone.coalescer.isEmpty() && player.isIdle()) {
             // 带超时的互斥锁获取
-            if (xSemaphoreTake(playerMutex, pdMS_TO_TICKS(20))) {
-                switch (cmd) {
-                case CMD_PLAY:
-                    player.playTrack(1);
-                    break;
-                case CMD_PAUSE:
-                    player.pause();
-                    break;
-                case CMD_STOP:
-                    player.stop();
-                    break;
-                case CMD_NEXT:
-                    player.playTrack(player.getTrack() + 1);
-                    break;
-                case CMD_PREV:
-                    player.playTrack(player.getTrack() - 1);
-                    break;
-                case CMD_VOL_UP:
-                    player.setVolume(player.getVolume() + 1);
-                    break;
-                case CMD_VOL_DOWN:
-                    player.setVolume(player.getVolume() - 1);
-                    break;
-                }
-                xSemaphoreGive(playerMutex);
+            if (xSemaphoreTake(zone.mutex, pdMS_TO_TICKS(20))) {
+                zone.coalescer.flush(player);
+                xSemaphoreGive(zone.mutex);
             }
         }
 
-        // 带超时的互斥锁获取用于音频处理
-        if (xSemaphoreTake(playerMutex, pdMS_TO_TICKS(10))) {
-
-            // 音频解码和播放处理
-            // 例如: player.audioProcess();
-            xSemaphoreGive(playerMutex);
+        // 推进命令收发：处理应答、超时并发送下一帧
+        if (xSemaphoreTake(zone.mutex, pdMS_TO_TICKS(10))) {
+            player.process();
+            xSemaphoreGive(zone.mutex);
         }
-
-        // 让出CPU
-        vTaskDelay(pdMS_TO_TICKS(5));
     }
 }
 
 [[noreturn]] void uiTask(void* pvParameters) {
     // 初始化UI系统
     OLED_UI_Init(&MainMenuPage);
+    bool wasTouched = false;
+#if PLAYER_SOFTWARE_DECODE
+    bool wasEnter = false;
+    bool wasBack = false;
+#endif
 
     while (true) {
         OLED_UI_MainLoop();
 
+        // 任意按键按下时预热待机中的模块，随后的播放无需等待唤醒
+        const bool touched = Key_GetEnterStatus() || Key_GetBackStatus() || Key_GetUpStatus() || Key_GetDownStatus();
+        if (touched && !wasTouched) {
+            for (PlayerZone& zone : zones) {
+                sendPlayerCommand(zone, CMD_WAKE);
+            }
+        }
+        wasTouched = touched;
+
         // 检测用户输入并发送播放命令
+#if PLAYER_SOFTWARE_DECODE
+        // 片内解码时确认键播放当前曲目、返回键停止，只在按下的瞬间发出请求
+        const bool enter = Key_GetEnterStatus();
+        const bool back = Key_GetBackStatus();
+        if (enter && !wasEnter) {
+            playSoftwareTrack(currentTrack);
+        } else if (back && !wasBack) {
+            pipeline.stop();
+        }
+        wasEnter = enter;
+        wasBack = back;
+        // 连续播放自动接上了下一首：当前曲目后移并重新设置相邻曲目
+        const uint32_t changes = pipeline.getTrackChanges();
+        if (changes != seenTrackChanges && trackCount > 0) {
+            currentTrack = (currentTrack + changes - seenTrackChanges) % trackCount;
+            seenTrackChanges = changes;
+            updateNeighbours();
+        }
+#else
         if (Key_GetEnterStatus()) {
-            PlayerCommand cmd = CMD_PLAY;
-            xQueueSend(playerCommandQueue, &cmd, 0);
+            sendPlayerCommand(zones[0], CMD_PLAY);
         } else if (Key_GetBackStatus()) {
-            PlayerCommand cmd = CMD_PAUSE;
-            xQueueSend(playerCommandQueue, &cmd, 0);
+            sendPlayerCommand(zones[0], CMD_PAUSE);
         }
+#endif
         // 其他按钮处理...
 
         // 栈溢出检测
@@ -128,11 +277,24 @@ void uiTimerCallback(TimerHandle_t xTimer) {
 // 启动任务用于初始化调度器后的操作
 void startupTask(void* pvParameters) {
     // 创建任务
-    TaskHandle_t playerHandle, uiHandle, ledHandle;
-    BaseType_t ret[3];
-    ret[0] = xTaskCreate(playerTask, "PLAYER", 4096, nullptr, 2, &playerHandle);
-    ret[1] = xTaskCreate(uiTask, "UI", 1536, nullptr, 3, &uiHandle); // 栈增加到1536
-    ret[2] = xTaskCreate(openLED, "LED", 256, nullptr, 4, &ledHandle);
+    TaskHandle_t uiHandle, ledHandle;
+    // ret[2] 为片内解码管线，未启用时保持 pdPASS
+    BaseType_t ret[3 + ZONE_COUNT];
+    // 播放器任务创建时即绑定核心，串口中断随 begin() 注册在同一核心上
+    for (int i = 0; i < ZONE_COUNT; i++) {
+        ret[3 + i] = xTaskCreateAffinitySet(playerTask, zones[i].name, 4096, &zones[i], 2,
+                                            1 << zones[i].core, &zones[i].task);
+    }
+    ret[0] = xTaskCreate(uiTask, "UI", 1536, nullptr, 3, &uiHandle); // 栈增加到1536
+    ret[1] = xTaskCreate(openLED, "LED", 256, nullptr, 4, &ledHandle);
+    ret[2] = pdPASS;
+#if PLAYER_SOFTWARE_DECODE
+    // 解码任务创建前扫描曲目表，此时没有其他任务访问 FatFs
+    scanTracks();
+    pipeline.setContinuous(true);
+    // 解码任务在 core 1 上以低于播放器任务的优先级运行，只占用其空闲时间
+    ret[2] = pipeline.begin(1) ? pdPASS : pdFAIL;
+#endif
     for (const BaseType_t val : ret) {
         if (val == pdFAIL) {
             panicBlink(5);
@@ -152,7 +314,6 @@ void startupTask(void* pvParameters) {
         }
     }
     vTaskCoreAffinitySet(uiHandle, 0x01);
-    vTaskCoreAffinitySet(playerHandle, 1 << 1);
     // 启动任务完成后删除自身
     vTaskDelete(nullptr);
 }
@@ -160,18 +321,21 @@ void startupTask(void* pvParameters) {
 [[noreturn]] int main() {
     stdio_init_all();
 
-    // 硬件初始化
+    // 硬件初始化（各区串口由 PlayerTF16P::begin() 初始化）
     gpio_init(PICO_DEFAULT_LED_PIN);
-    uart_init(uart1, 9600);
-    gpio_set_function(4, GPIO_FUNC_UART);
-    gpio_set_function(5, GPIO_FUNC_UART);
+#if PLAYER_SOFTWARE_DECODE
+    // 延迟挂载，首次打开文件时才初始化SD卡
+    f_mount(&filesystem, "", 0);
+#endif
 
     // 创建同步机制
-    playerMutex = xSemaphoreCreateMutex();
-    playerCommandQueue = xQueueCreate(10, sizeof(PlayerCommand));
-    if (!playerMutex || !playerCommandQueue) {
-        // 提示初始化失败，比如点亮LED或打印错误信息
-        panicBlink(2);
+    for (PlayerZone& zone : zones) {
+        zone.mutex = xSemaphoreCreateMutex();
+        zone.commands = xQueueCreate(10, sizeof(PlayerCommand));
+        if (!zone.mutex || !zone.commands) {
+            // 提示初始化失败，比如点亮LED或打印错误信息
+            panicBlink(2);
+        }
     }
 
 
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <math.h>
+#include "HostTest.h"
+#include "AudioDsp.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 音效各级的每样本开销：1、4、8 段均衡，补回提升的限幅级，以及逐档过渡中的音量级。
+// 主机上的周期数只用来比较各级的相对开销，固件上的实际值见 AudioStats 的 dsp cycles/sample
+namespace {
+constexpr uint16_t FRAMES = 576;
+constexpr uint32_t PERIODS = 4000;
+constexpr uint32_t RATE = 44100;
+uint32_t source[FRAMES];
+uint32_t period[FRAMES];
+
+uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct Cost {
+    double ns;
+    double cycles;
+};
+
+// 每次处理前恢复同一段音乐样的输入，只计入被测的一级
+template <typename Stage>
+Cost perSample(Stage stage) {
+    uint64_t spentCycles = 0;
+    std::chrono::steady_clock::duration spent{};
+    for (uint32_t p = 0; p < PERIODS; p++) {
+        for (uint16_t i = 0; i < FRAMES; i++) {
+            period[i] = source[i];
+        }
+        const uint64_t startCycles = cycles();
+        const auto start = std::chrono::steady_clock::now();
+        stage(period);
+        spent += std::chrono::steady_clock::now() - start;
+        spentCycles += cycles() - startCycles;
+    }
+    const double samples = static_cast<double>(PERIODS) * FRAMES * 2;
+    return {std::chrono::duration<double, std::nano>(spent).count() / samples, spentCycles / samples};
+}
+
+AudioDsp& equalizer(const uint8_t count) {
+    static AudioDsp dsp[AudioDsp::MAX_BANDS + 1];
+    AudioDsp& target = dsp[count];
+    target.setSampleRate(RATE);
+    for (uint8_t i = 0; i < count; i++) {
+        EqBand band;
+        band.enabled = true;
+        band.type = i == 0 ? FilterType::LOW_SHELF : FilterType::PEAKING;
+        band.frequencyHz = 60.0f * static_cast<float>(1 << i);
+        band.gainDb = i % 2 ? -3.0f : 1.5f;
+        band.q = 1.0f;
+        EXPECT(target.setBand(i, band));
+    }
+    return target;
+}
+}
+
+int main() {
+    for (uint16_t i = 0; i < FRAMES; i++) {
+        const auto l = static_cast<int16_t>(lround(9000.0 * sin(i * 0.0137) + 3000.0 * sin(i * 0.71)));
+        const auto r = static_cast<int16_t>(lround(9000.0 * sin(i * 0.0191) - 3000.0 * sin(i * 0.53)));
+        source[i] = static_cast<uint32_t>(static_cast<uint16_t>(l)) << 16 | static_cast<uint16_t>(r);
+    }
+    printf("dsp stage          ns/sample  cycles/sample\n");
+    Cost stageCost{};
+    const uint8_t counts[] = {1, 4, 8};
+    for (const uint8_t count : counts) {
+        AudioDsp& dsp = equalizer(count);
+        const Cost cost = perSample([&dsp](uint32_t* data) { dsp.applyEqualizer(data, FRAMES); });
+        printf("equalizer x%u       %8.2f       %8.1f\n", count, cost.ns, cost.cycles);
+        if (count == 8) {
+            stageCost = {cost.ns / 8, cost.cycles / 8};
+        }
+    }
+    printf("  per stage        %8.2f       %8.1f\n", stageCost.ns, stageCost.cycles);
+    AudioDsp& boosted = equalizer(8);
+    const Cost limiter = perSample([&boosted](uint32_t* data) { boosted.applyLimiter(data, FRAMES); });
+    printf("limiter            %8.2f       %8.1f\n", limiter.ns, limiter.cycles);
+    AudioDsp fading;
+    uint8_t attenuation = 0;
+    const Cost volume = perSample([&fading, &attenuation](uint32_t* data) {
+        // 每个周期都在过渡，走插值的路径
+        fading.setAttenuation(attenuation = attenuation ? 0 : 40);
+        fading.applyVolume(data, FRAMES);
+    });
+    printf("volume (ramping)   %8.2f       %8.1f\n", volume.ns, volume.cycles);
+    // 量级检查：即使未优化的主机构建，一段均衡每样本也远低于1微秒
+    EXPECT(stageCost.ns < 1000.0);
+    EXPECT(limiter.ns < 1000.0);
+    EXPECT(volume.ns < 1000.0);
+    return testResult("AudioDspBench");
+}
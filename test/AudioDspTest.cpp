@@ -0,0 +1,175 @@
+#include <math.h>
+#include "HostTest.h"
+#include "AudioDsp.h"
+
+// 音效链的定点行为：低频搁架和窄峰在冲激或音调结束后回到精确的0（无直流残留、无极限环），
+// 提升与衰减的幅度，以及各段提升之和的上限
+namespace {
+constexpr uint16_t FRAMES = 576;
+constexpr uint32_t RATE = 44100;
+uint32_t period[FRAMES];
+
+EqBand band(const FilterType type, const float frequencyHz, const float gainDb, const float q = 0.707f) {
+    EqBand eq;
+    eq.enabled = true;
+    eq.type = type;
+    eq.frequencyHz = frequencyHz;
+    eq.gainDb = gainDb;
+    eq.q = q;
+    return eq;
+}
+
+// 处理 count 个静音周期，返回最后一个周期中最大的绝对值
+int32_t silence(AudioDsp& dsp, const uint32_t count) {
+    int32_t largest = 0;
+    for (uint32_t p = 0; p < count; p++) {
+        for (uint32_t& word : period) {
+            word = 0;
+        }
+        dsp.process(period, FRAMES);
+        largest = 0;
+        for (const uint32_t word : period) {
+            const int32_t l = static_cast<int32_t>(word) >> 16;
+            const int32_t r = static_cast<int16_t>(word);
+            largest = abs(l) > largest ? abs(l) : largest;
+            largest = abs(r) > largest ? abs(r) : largest;
+        }
+    }
+    return largest;
+}
+
+// 两个声道输入同一正弦，返回后一半周期中左声道的 RMS 相对输入 RMS 的 dB 数（前一半留给滤波器建立）
+double tone(AudioDsp& dsp, const double frequencyHz, const double amplitude, const uint32_t count) {
+    static double phase = 0.0;
+    double energy = 0.0;
+    for (uint32_t p = 0; p < count; p++) {
+        if (p == count / 2) {
+            energy = 0.0;
+        }
+        for (uint32_t& word : period) {
+            const int32_t sample = static_cast<int32_t>(lround(amplitude * sin(phase)));
+            phase += 2.0 * M_PI * frequencyHz / RATE;
+            word = static_cast<uint32_t>(sample) << 16 | static_cast<uint16_t>(sample);
+        }
+        dsp.process(period, FRAMES);
+        for (const uint32_t word : period) {
+            const double l = static_cast<int32_t>(word) >> 16;
+            energy += l * l;
+        }
+    }
+    const double rms = sqrt(energy / ((count - count / 2) * FRAMES));
+    return 20.0 * log10(rms / (amplitude / sqrt(2.0)));
+}
+
+void expectNear(const double actual, const double expected, const double tolerance, const char* what) {
+    if (fabs(actual - expected) > tolerance) {
+        printf("%s: %.2f dB, expected %.2f +- %.2f\n", what, actual, expected, tolerance);
+        testFailures()++;
+    }
+}
+
+void testImpulseDecay() {
+    const EqBand cases[] = {
+        band(FilterType::LOW_SHELF, 60.0f, 12.0f),
+        band(FilterType::LOW_SHELF, 60.0f, -12.0f),
+        band(FilterType::LOW_SHELF, 200.0f, 12.0f),
+        band(FilterType::PEAKING, 1000.0f, 12.0f, 4.0f),
+        band(FilterType::HIGH_SHELF, 8000.0f, -12.0f),
+    };
+    for (const EqBand& eq : cases) {
+        AudioDsp dsp;
+        dsp.setSampleRate(RATE);
+        EXPECT(dsp.setBand(0, eq));
+        for (uint32_t& word : period) {
+            word = 0;
+        }
+        period[0] = static_cast<uint32_t>(16384) << 16 | static_cast<uint16_t>(-16384);
+        dsp.process(period, FRAMES);
+        // 3秒后应已精确归零
+        EXPECT_EQ(silence(dsp, 3 * RATE / FRAMES), 0);
+    }
+}
+
+void testToneThenSilence() {
+    const EqBand cases[] = {
+        band(FilterType::LOW_SHELF, 60.0f, 12.0f),
+        band(FilterType::LOW_SHELF, 60.0f, -12.0f),
+        band(FilterType::LOW_SHELF, 200.0f, 6.0f),
+        band(FilterType::PEAKING, 1000.0f, -12.0f, 2.0f),
+    };
+    for (const EqBand& eq : cases) {
+        AudioDsp dsp;
+        dsp.setSampleRate(RATE);
+        EXPECT(dsp.setBand(0, eq));
+        tone(dsp, 60.0, 6000.0, RATE / FRAMES);
+        EXPECT_EQ(silence(dsp, 3 * RATE / FRAMES), 0);
+    }
+    // 多段串联同样归零
+    AudioDsp dsp;
+    dsp.setSampleRate(RATE);
+    EXPECT(dsp.setBand(0, band(FilterType::LOW_SHELF, 60.0f, 6.0f)));
+    EXPECT(dsp.setBand(1, band(FilterType::PEAKING, 120.0f, -9.0f, 2.0f)));
+    EXPECT(dsp.setBand(2, band(FilterType::PEAKING, 3000.0f, 6.0f, 1.0f)));
+    EXPECT(dsp.setBand(3, band(FilterType::HIGH_SHELF, 10000.0f, -6.0f)));
+    tone(dsp, 90.0, 6000.0, RATE / FRAMES);
+    EXPECT_EQ(silence(dsp, 3 * RATE / FRAMES), 0);
+}
+
+void testResponse() {
+    AudioDsp flat;
+    flat.setSampleRate(RATE);
+    expectNear(tone(flat, 1000.0, 8000.0, 10), 0.0, 0.05, "flat 1k");
+
+    AudioDsp peak;
+    peak.setSampleRate(RATE);
+    EXPECT(peak.setBand(0, band(FilterType::PEAKING, 1000.0f, 6.0f, 1.0f)));
+    expectNear(tone(peak, 1000.0, 4000.0, 20), 6.0, 0.2, "+6 peak at 1k");
+    expectNear(tone(peak, 100.0, 4000.0, 40), 0.0, 0.2, "+6 peak at 100");
+
+    AudioDsp cut;
+    cut.setSampleRate(RATE);
+    EXPECT(cut.setBand(0, band(FilterType::PEAKING, 1000.0f, -6.0f, 1.0f)));
+    expectNear(tone(cut, 1000.0, 8000.0, 20), -6.0, 0.2, "-6 peak at 1k");
+    expectNear(tone(cut, 100.0, 8000.0, 40), 0.0, 0.2, "-6 peak at 100");
+
+    // 低频搁架：1 - cos(w0) 只有1e-5量级，系数精度不够时这里偏差数dB（理想值 20Hz 11.80dB、60Hz 6.00dB）
+    AudioDsp shelf;
+    shelf.setSampleRate(RATE);
+    EXPECT(shelf.setBand(0, band(FilterType::LOW_SHELF, 60.0f, 12.0f)));
+    expectNear(tone(shelf, 20.0, 2000.0, 160), 11.80, 0.2, "+12 shelf at 20");
+    expectNear(tone(shelf, 60.0, 2000.0, 80), 6.0, 0.2, "+12 shelf at 60");
+    expectNear(tone(shelf, 2000.0, 2000.0, 20), 0.0, 0.1, "+12 shelf at 2k");
+
+    // 两段各提升6dB叠加到12dB：级间预先衰减，-14dBFS 的输入提升后不被削波
+    AudioDsp stacked;
+    stacked.setSampleRate(RATE);
+    EXPECT(stacked.setBand(0, band(FilterType::LOW_SHELF, 200.0f, 6.0f)));
+    EXPECT(stacked.setBand(1, band(FilterType::PEAKING, 60.0f, 6.0f, 1.0f)));
+    expectNear(tone(stacked, 60.0, 6500.0, 80), 12.0, 0.2, "stacked boost at 60");
+    expectNear(tone(stacked, 5000.0, 6500.0, 20), 0.0, 0.2, "stacked boost at 5k");
+}
+
+void testBoostLimit() {
+    AudioDsp dsp;
+    dsp.setSampleRate(RATE);
+    EXPECT(dsp.setBand(0, band(FilterType::PEAKING, 100.0f, 6.0f)));
+    EXPECT(dsp.setBand(1, band(FilterType::PEAKING, 1000.0f, 6.0f)));
+    // 第三段提升会超过 MAX_TOTAL_BOOST_DB，不生效
+    EXPECT(!dsp.setBand(2, band(FilterType::PEAKING, 5000.0f, 1.0f)));
+    EXPECT(!dsp.getBand(2).enabled);
+    // 衰减不占用提升预算；替换已有的段时按替换后的总和计算
+    EXPECT(dsp.setBand(2, band(FilterType::PEAKING, 5000.0f, -12.0f)));
+    EXPECT(dsp.setBand(1, band(FilterType::PEAKING, 1000.0f, 4.0f)));
+    EXPECT(dsp.setBand(3, band(FilterType::PEAKING, 8000.0f, 2.0f)));
+    EXPECT(!dsp.setBand(3, band(FilterType::PEAKING, 8000.0f, 3.0f)));
+    EXPECT_EQ(dsp.getBand(3).gainDb, 2.0f);
+}
+} // namespace
+
+int main() {
+    testImpulseDecay();
+    testToneThenSilence();
+    testResponse();
+    testBoostLimit();
+    return testResult("AudioDspTest");
+}
@@ -0,0 +1,111 @@
+#include "HostTest.h"
+#include "PlayerCommand.h"
+#include "TF16PEmulator.h"
+
+namespace {
+TF16PEmulator::Config quietConfig() {
+    TF16PEmulator::Config config;
+    config.jitterUs = 0;
+    config.bootMs = 10;
+    return config;
+}
+
+void testVolumeAndTrackBurst() {
+    TF16PEmulator emulator(quietConfig());
+    PlayerTF16P player(4, 5, uart1);
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isReady() && p.isIdle(); }, 2000));
+    player.setVolume(10);
+    runFor(player, 500);
+
+    CommandCoalescer coalescer;
+    for (int i = 0; i < 5; i++) {
+        coalescer.add(CMD_VOL_UP);
+    }
+    coalescer.add(CMD_VOL_DOWN);
+    coalescer.add(CMD_NEXT);
+    coalescer.add(CMD_NEXT);
+    EXPECT_EQ(coalescer.flush(player), 2);
+    EXPECT_EQ(coalescer.getReceived(), 8);
+    EXPECT_EQ(coalescer.getSavedFrames(), 6);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isIdle(); }, 2000));
+    EXPECT_EQ(player.getVolume(), 14);
+    EXPECT_EQ(player.getTrack(), 3);
+}
+
+void testPlayThenPauseCancels() {
+    TF16PEmulator emulator(quietConfig());
+    PlayerTF16P player(4, 5, uart1);
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    CommandCoalescer coalescer;
+    coalescer.add(CMD_PLAY);
+    coalescer.add(CMD_PAUSE);
+    EXPECT(!coalescer.isEmpty());
+    EXPECT_EQ(coalescer.flush(player), 0);
+    EXPECT_EQ(coalescer.getSavedFrames(), 2);
+    EXPECT(coalescer.isEmpty());
+}
+
+void testWakeWithoutFrameIsNotSaved() {
+    TF16PEmulator emulator(quietConfig());
+    PlayerTF16P player(4, 5, uart1);
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isReady() && p.isIdle(); }, 2000));
+    CommandCoalescer coalescer;
+    // 模块醒着：唤醒不发帧，也不算省去
+    coalescer.add(CMD_WAKE);
+    coalescer.add(CMD_VOL_UP);
+    EXPECT_EQ(coalescer.flush(player), 1);
+    EXPECT_EQ(coalescer.getSavedFrames(), 0);
+    // 待机中：一批里多次唤醒只发一帧唤醒，其余本来也不会发送
+    player.setStandby(100);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isAsleep(); }, 2000));
+    coalescer.add(CMD_WAKE);
+    coalescer.add(CMD_WAKE);
+    coalescer.add(CMD_VOL_UP);
+    coalescer.add(CMD_VOL_UP);
+    EXPECT_EQ(coalescer.flush(player), 2);
+    EXPECT_EQ(coalescer.getSavedFrames(), 1);
+    EXPECT(!player.isAsleep());
+}
+
+void testCollapsedAndRejectedAreNotFrames() {
+    TF16PEmulator emulator(quietConfig());
+    PlayerTF16P player(4, 5, uart1);
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isReady() && p.isIdle(); }, 2000));
+    CommandCoalescer coalescer;
+    // 队尾还有未发送的音量帧：合并结果被播放器并入该帧，没有新帧
+    player.setVolume(10);
+    coalescer.add(CMD_VOL_UP);
+    EXPECT_EQ(coalescer.flush(player), 0);
+    EXPECT_EQ(coalescer.getEmitted(), 0);
+    EXPECT_EQ(coalescer.getSavedFrames(), 1);
+    EXPECT_EQ(player.getCollapsedFrames(), 1);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isIdle(); }, 2000));
+    // 队列已满：命令被拒绝，既不算发出也不算省去
+    while (player.stop() != INVALID_COMMAND) {
+    }
+    coalescer.add(CMD_PAUSE);
+    coalescer.add(CMD_NEXT);
+    EXPECT_EQ(coalescer.flush(player), 0);
+    EXPECT_EQ(coalescer.getRejected(), 1);
+    EXPECT_EQ(coalescer.getEmitted(), 0);
+    EXPECT_EQ(coalescer.getSavedFrames(), 2);
+}
+}
+
+int main() {
+    testVolumeAndTrackBurst();
+    host_clear_alarms();
+    testPlayThenPauseCancels();
+    host_clear_alarms();
+    testWakeWithoutFrameIsNotSaved();
+    host_clear_alarms();
+    testCollapsedAndRejectedAreNotFrames();
+    return testResult("CommandCoalescerTest");
+}
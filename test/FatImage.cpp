@@ -0,0 +1,109 @@
+#include "FatImage.h"
+#include <string.h>
+#include <vector>
+#include "ff.h"
+#include "diskio.h"
+
+namespace {
+constexpr uint16_t SECTOR = 512;
+constexpr uint8_t CLUSTER_SECTORS = 16;
+constexpr uint16_t ROOT_ENTRIES = 512;
+std::vector<uint8_t> image;
+FatImage::Counters totals{};
+FATFS volume;
+
+void put16(uint8_t* at, const uint16_t value) {
+    at[0] = static_cast<uint8_t>(value);
+    at[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void put32(uint8_t* at, const uint32_t value) {
+    put16(at, static_cast<uint16_t>(value));
+    put16(at + 2, static_cast<uint16_t>(value >> 16));
+}
+}
+
+bool FatImage::format(const uint32_t sectors) {
+    const uint32_t rootSectors = ROOT_ENTRIES * 32 / SECTOR;
+    // FAT 大小按全部扇区估算，略多于数据区实际需要
+    const uint32_t fatSectors = (sectors / CLUSTER_SECTORS + 2) * 2 / SECTOR + 1;
+    const uint32_t clusters = (sectors - 1 - 2 * fatSectors - rootSectors) / CLUSTER_SECTORS;
+    if (clusters < 4085 || clusters > 65524) {
+        return false;
+    }
+    image.assign(static_cast<size_t>(sectors) * SECTOR, 0);
+    uint8_t* boot = image.data();
+    memcpy(boot, "\xEB\x3C\x90" "MSWIN4.1", 11);
+    put16(boot + 11, SECTOR);
+    boot[13] = CLUSTER_SECTORS;
+    put16(boot + 14, 1);
+    boot[16] = 2;
+    put16(boot + 17, ROOT_ENTRIES);
+    put16(boot + 19, sectors < 0x10000 ? static_cast<uint16_t>(sectors) : 0);
+    boot[21] = 0xF8;
+    put16(boot + 22, static_cast<uint16_t>(fatSectors));
+    put16(boot + 24, 63);
+    put16(boot + 26, 255);
+    put32(boot + 32, sectors < 0x10000 ? 0 : sectors);
+    boot[36] = 0x80;
+    boot[38] = 0x29;
+    put32(boot + 39, 0x20241101);
+    memcpy(boot + 43, "NO NAME    FAT16   ", 19);
+    boot[510] = 0x55;
+    boot[511] = 0xAA;
+    for (uint8_t fat = 0; fat < 2; fat++) {
+        uint8_t* table = image.data() + (1 + fat * fatSectors) * SECTOR;
+        put16(table, 0xFFF8);
+        put16(table + 2, 0xFFFF);
+    }
+    totals = {};
+    return f_mount(&volume, "", 1) == FR_OK;
+}
+
+FatImage::Counters& FatImage::counters() {
+    return totals;
+}
+
+extern "C" {
+DSTATUS disk_initialize(BYTE) {
+    return image.empty() ? STA_NOINIT : 0;
+}
+
+DSTATUS disk_status(BYTE) {
+    return image.empty() ? STA_NOINIT : 0;
+}
+
+DRESULT disk_read(BYTE, BYTE* buff, const LBA_t sector, const UINT count) {
+    if ((static_cast<size_t>(sector) + count) * SECTOR > image.size()) {
+        return RES_PARERR;
+    }
+    memcpy(buff, image.data() + static_cast<size_t>(sector) * SECTOR, count * SECTOR);
+    totals.readCommands++;
+    totals.sectorsRead += count;
+    return RES_OK;
+}
+
+DRESULT disk_write(BYTE, const BYTE* buff, const LBA_t sector, const UINT count) {
+    if ((static_cast<size_t>(sector) + count) * SECTOR > image.size()) {
+        return RES_PARERR;
+    }
+    memcpy(image.data() + static_cast<size_t>(sector) * SECTOR, buff, count * SECTOR);
+    totals.sectorsWritten += count;
+    return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE, const BYTE cmd, void* buff) {
+    switch (cmd) {
+        case CTRL_SYNC:
+            return RES_OK;
+        case GET_SECTOR_COUNT:
+            *static_cast<LBA_t*>(buff) = static_cast<LBA_t>(image.size() / SECTOR);
+            return RES_OK;
+        case GET_BLOCK_SIZE:
+            *static_cast<DWORD*>(buff) = 1;
+            return RES_OK;
+        default:
+            return RES_PARERR;
+    }
+}
+}
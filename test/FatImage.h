@@ -0,0 +1,20 @@
+#ifndef FAT_IMAGE_H
+#define FAT_IMAGE_H
+#include <stdint.h>
+
+// FatFs 的主机磁盘：内存中的 FAT16 映像代替固件的 SPI SD 驱动（lib/fatfs/diskio.c），
+// 让 FileReader 和 SeekIndex 在主机上走与设备相同的 FatFs 路径。按读命令和扇区计数，基准据此估算卡上的耗时
+namespace FatImage {
+struct Counters {
+    uint64_t readCommands;
+    uint64_t sectorsRead;
+    uint64_t sectorsWritten;
+};
+
+// 建立 sectors 个512字节扇区的映像（每簇16扇区即8KB，簇数须在 FAT16 的 4085 到 65524 之间）、写入 FAT16 引导扇区和空的 FAT 并挂载
+bool format(uint32_t sectors);
+
+Counters& counters();
+}
+
+#endif // FAT_IMAGE_H
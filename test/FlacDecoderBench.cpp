@@ -0,0 +1,113 @@
+#include <chrono>
+#include <stdlib.h>
+#include "HostTest.h"
+#include "FlacDecoder.h"
+#include "stream_encoder.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// FLAC 解码基准：用 libFLAC 编码器生成一段合成立体声，再经 FileReader 和 FlacDecoder 完整解码，
+// 报告输入 MB/s 与每样本的耗时/周期数，并逐样本核对解码结果与原始信号一致
+namespace {
+constexpr uint32_t SAMPLE_RATE = 44100;
+constexpr uint32_t SECONDS = 60;
+constexpr uint32_t FRAMES = SAMPLE_RATE * SECONDS;
+constexpr const char* PATH = "FlacDecoderBench.flac";
+
+// 确定的合成信号：两路不同周期的三角波叠加小幅噪声，既有可预测部分也有残差，接近实际音乐的压缩率
+int16_t sampleAt(const uint32_t frame, const int channel) {
+    static uint32_t noise = 0x9E3779B9;
+    noise ^= noise << 13;
+    noise ^= noise >> 17;
+    noise ^= noise << 5;
+    const uint32_t period = channel ? 173 : 101;
+    const int32_t phase = static_cast<int32_t>(frame % period) * 2 * 24000 / period - 24000;
+    const int32_t triangle = phase < 0 ? -phase : phase;
+    return static_cast<int16_t>(triangle - 12000 + static_cast<int32_t>(noise % 512) - 256);
+}
+
+bool encode(int16_t* source) {
+    FLAC__StreamEncoder* encoder = FLAC__stream_encoder_new();
+    if (encoder == nullptr) {
+        return false;
+    }
+    FLAC__stream_encoder_set_channels(encoder, 2);
+    FLAC__stream_encoder_set_bits_per_sample(encoder, 16);
+    FLAC__stream_encoder_set_sample_rate(encoder, SAMPLE_RATE);
+    FLAC__stream_encoder_set_compression_level(encoder, 5);
+    FLAC__stream_encoder_set_total_samples_estimate(encoder, FRAMES);
+    bool ok = FLAC__stream_encoder_init_file(encoder, PATH, nullptr, nullptr) == FLAC__STREAM_ENCODER_INIT_STATUS_OK;
+    static FLAC__int32 block[4096 * 2];
+    for (uint32_t frame = 0; ok && frame < FRAMES; frame += 4096) {
+        const uint32_t count = FRAMES - frame < 4096 ? FRAMES - frame : 4096;
+        for (uint32_t i = 0; i < count * 2; i++) {
+            source[frame * 2 + i] = sampleAt(frame + i / 2, i & 1);
+            block[i] = source[frame * 2 + i];
+        }
+        ok = FLAC__stream_encoder_process_interleaved(encoder, block, count);
+    }
+    ok = FLAC__stream_encoder_finish(encoder) && ok;
+    FLAC__stream_encoder_delete(encoder);
+    return ok;
+}
+
+struct Check {
+    const int16_t* source;
+    uint32_t frames;
+    uint32_t mismatches;
+};
+
+void compare(const int16_t* samples, const uint32_t frames, void* arg) {
+    auto* check = static_cast<Check*>(arg);
+    for (uint32_t i = 0; i < frames * 2; i++) {
+        const uint32_t at = check->frames * 2 + i;
+        check->mismatches += at >= FRAMES * 2 || samples[i] != check->source[at];
+    }
+    check->frames += frames;
+}
+
+uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+}
+
+int main() {
+    auto* source = static_cast<int16_t*>(malloc(FRAMES * 2 * sizeof(int16_t)));
+    EXPECT(encode(source));
+    static FileReader reader;
+    static FlacDecoder decoder;
+    EXPECT(reader.open(PATH));
+    Check check{source, 0, 0};
+    EXPECT(decoder.start(reader, compare, &check));
+    EXPECT_EQ(decoder.getSampleRate(), SAMPLE_RATE);
+    EXPECT_EQ(decoder.getChannels(), 2);
+
+    const uint64_t startCycles = cycles();
+    const auto start = std::chrono::steady_clock::now();
+    while (decoder.decode() > 0) {
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t elapsedCycles = cycles() - startCycles;
+    decoder.finish();
+
+    const double samples = static_cast<double>(FRAMES) * 2;
+    printf("input %.2f MB (%.1f%% of PCM), %u s of 44.1kHz stereo\n", reader.size() / 1e6,
+           reader.size() * 100.0 / (samples * 2), SECONDS);
+    printf("decode %.1f MB/s input, %.1fx realtime, %.2f ns/sample", reader.size() / 1e6 / seconds,
+           SECONDS / seconds, seconds * 1e9 / samples);
+    if (elapsedCycles) {
+        printf(", %.1f cycles/sample", elapsedCycles / samples);
+    }
+    printf("\n");
+    reader.close();
+    remove(PATH);
+    EXPECT_EQ(check.frames, FRAMES);
+    EXPECT_EQ(check.mismatches, 0);
+    free(source);
+    return testResult("FlacDecoderBench");
+}
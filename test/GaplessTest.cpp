@@ -0,0 +1,157 @@
+#include <stdlib.h>
+#include <vector>
+#include "HostTest.h"
+#include "Mp3Decoder.h"
+
+// 无缝播放的逐样本检查：把一张 3M 样本的专辑切成长度、编码器延迟随机的若干首，交替用 LAME 标签和
+// iTunSMPB（UTF-16 的 ID3v2 注释）记录延迟与填充，经 Mp3Decoder 依次解码后拼接的输出必须与整张专辑逐样本相同。
+// 解码由 test/fake/minimp3.h 代替，样本值即其在专辑中的位置，裁剪多一个或少一个样本都会被发现
+FakeMp3Track fakeMp3Tracks[FAKE_MP3_TRACKS];
+
+namespace {
+constexpr char PATH[] = "GaplessTest.mp3";
+constexpr uint32_t ALBUM = 3000000;
+constexpr uint16_t FRAME = 1152;
+constexpr uint16_t DECODER_DELAY = 529;
+constexpr uint16_t INFO_BYTES = 417;
+constexpr uint8_t FRAME_BYTES = 8;
+const uint8_t HEADER[4] = {0xFF, 0xFB, 0x90, 0x44};
+
+void append(std::vector<uint8_t>& data, const void* bytes, const size_t length) {
+    const auto* begin = static_cast<const uint8_t*>(bytes);
+    data.insert(data.end(), begin, begin + length);
+}
+
+// iTunes 的 COMM 帧：描述 "iTunSMPB"，正文为十六进制的延迟、填充与长度
+std::vector<uint8_t> iTunesTag(const uint32_t delay, const uint32_t padding, const uint32_t length) {
+    char text[64];
+    snprintf(text, sizeof(text), " 00000000 %08X %08X %016X 00000000", delay, padding, length);
+    std::vector<uint8_t> body = {1, 'e', 'n', 'g', 0xFF, 0xFE};
+    for (const char* c = "iTunSMPB"; *c; c++) {
+        body.push_back(*c);
+        body.push_back(0);
+    }
+    const uint8_t separator[4] = {0, 0, 0xFF, 0xFE};
+    append(body, separator, sizeof(separator));
+    for (const char* c = text; *c; c++) {
+        body.push_back(*c);
+        body.push_back(0);
+    }
+    std::vector<uint8_t> frame = {'C', 'O', 'M', 'M', 0, 0, static_cast<uint8_t>(body.size() >> 8),
+                                  static_cast<uint8_t>(body.size()), 0, 0};
+    append(frame, body.data(), body.size());
+    std::vector<uint8_t> tag = {'I', 'D', '3', 3, 0, 0, 0, 0, static_cast<uint8_t>(frame.size() >> 7),
+                                static_cast<uint8_t>(frame.size() & 0x7F)};
+    append(tag, frame.data(), frame.size());
+    return tag;
+}
+
+// 写出一首：Info 帧（帧数与可选的 LAME 延迟/填充）后接各音频帧；reservoirFrame 为模拟比特池不足的帧序号
+uint32_t writeTrack(const uint32_t delay, const uint32_t length, const bool itunes, const uint32_t reservoirFrame) {
+    const uint32_t frames = (delay + length + DECODER_DELAY + FRAME - 1) / FRAME;
+    const uint32_t padding = frames * FRAME - delay - length;
+    std::vector<uint8_t> data;
+    if (itunes) {
+        data = iTunesTag(delay, padding, length);
+    }
+    uint8_t info[INFO_BYTES]{};
+    memcpy(info, HEADER, sizeof(HEADER));
+    memcpy(info + 36, "Info", 4);
+    info[43] = 0x0F;
+    info[44] = frames >> 24;
+    info[45] = frames >> 16;
+    info[46] = frames >> 8;
+    info[47] = frames;
+    if (!itunes) {
+        uint8_t* lame = info + 156;
+        memcpy(lame, "LAME3.100", 9);
+        lame[21] = delay >> 4;
+        lame[22] = (delay & 15) << 4 | padding >> 8;
+        lame[23] = padding & 0xFF;
+    }
+    append(data, info, sizeof(info));
+    for (uint32_t k = 0; k < frames; k++) {
+        const uint32_t number = k | (k == reservoirFrame ? 0x80000000u : 0);
+        append(data, HEADER, sizeof(HEADER));
+        append(data, &number, sizeof(number));
+    }
+    FILE* out = fopen(PATH, "wb");
+    EXPECT(out != nullptr);
+    if (out) {
+        EXPECT_EQ(fwrite(data.data(), 1, data.size(), out), data.size());
+        fclose(out);
+    }
+    return static_cast<uint32_t>(data.size() - frames * FRAME_BYTES);
+}
+
+void testSplitAlbum() {
+    static FileReader reader;
+    static Mp3Decoder mp3;
+    std::vector<int16_t> out;
+    uint32_t at = 0;
+    uint32_t tracks = 0;
+    srand(7);
+    while (at < ALBUM) {
+        const uint32_t length = ALBUM - at < 20000 + 400000u ? ALBUM - at : 20000 + rand() % 400000;
+        const uint32_t delay = 576 + rand() % 1200;
+        writeTrack(delay, length, tracks % 2, UINT32_MAX);
+        fakeMp3Tracks[0] = {at, delay, length, 0};
+        EXPECT(reader.open(PATH));
+        mp3.start(reader);
+        EXPECT(mp3.isGapless());
+        while (const uint32_t count = mp3.decode(reader)) {
+            out.insert(out.end(), mp3.pcm(), mp3.pcm() + count);
+        }
+        reader.close();
+        at += length;
+        tracks++;
+    }
+    EXPECT_EQ(out.size(), ALBUM);
+    uint64_t mismatches = 0;
+    for (uint32_t i = 0; i < ALBUM && i < out.size(); i++) {
+        mismatches += out[i] != static_cast<int16_t>(i & 0x7FFF);
+    }
+    EXPECT_EQ(mismatches, 0);
+    printf("%u tracks, %zu samples, %llu mismatches\n", tracks, out.size(), static_cast<unsigned long long>(mismatches));
+}
+
+// 定位：从 frameOf() 给出的帧重新开始，第一帧的输出覆盖目标样本；重新开始后的第一帧因比特池不足
+// 不出样本时，下一帧的输出仍按帧号正确裁剪
+void testRestart() {
+    static FileReader reader;
+    static Mp3Decoder mp3;
+    const uint32_t delay = 1000;
+    const uint32_t target = 100000;
+    for (const bool starved : {false, true}) {
+        const uint32_t audio = writeTrack(delay, 500000, false, UINT32_MAX);
+        fakeMp3Tracks[0] = {0, delay, 500000, 0};
+        EXPECT(reader.open(PATH));
+        mp3.start(reader);
+        const uint32_t frame = mp3.frameOf(target, FRAME);
+        // 第0帧是 Info 帧，第 frame 帧即第 frame - 1 个音频帧
+        if (starved) {
+            writeTrack(delay, 500000, false, frame - 1);
+            reader.open(PATH);
+            mp3.start(reader);
+        }
+        EXPECT(reader.seek(audio + (frame - 1) * FRAME_BYTES));
+        mp3.restart(frame);
+        const uint32_t count = mp3.decode(reader);
+        EXPECT_EQ(count, FRAME);
+        const int32_t first = mp3.pcm()[0];
+        const uint32_t expected = (starved ? frame : frame - 1) * FRAME - DECODER_DELAY - delay;
+        EXPECT_EQ(first, static_cast<int16_t>(expected & 0x7FFF));
+        if (!starved) {
+            EXPECT(expected <= target && target < expected + FRAME);
+        }
+        reader.close();
+    }
+}
+} // namespace
+
+int main() {
+    testSplitAlbum();
+    testRestart();
+    remove(PATH);
+    return testResult("GaplessTest");
+}
@@ -0,0 +1,67 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+#include <stdint.h>
+#include <stdio.h>
+#include "HostHal.h"
+#include "pico/time.h"
+
+// 主机测试的最小断言：失败时打印位置并计数，main() 以 testResult() 作为退出码
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define EXPECT(condition)                                                          \
+    do {                                                                           \
+        if (!(condition)) {                                                        \
+            printf("%s:%d: EXPECT(%s) failed\n", __FILE__, __LINE__, #condition); \
+            testFailures()++;                                                      \
+        }                                                                          \
+    } while (0)
+
+#define EXPECT_EQ(actual, expected)                                                              \
+    do {                                                                                         \
+        const long long actualValue = static_cast<long long>(actual);                            \
+        const long long expectedValue = static_cast<long long>(expected);                        \
+        if (actualValue != expectedValue) {                                                      \
+            printf("%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, actualValue, \
+                   expectedValue);                                                               \
+            testFailures()++;                                                                    \
+        }                                                                                        \
+    } while (0)
+
+inline int testResult(const char* name) {
+    printf("%s: %s\n", name, testFailures() ? "FAILED" : "passed");
+    return testFailures() ? 1 : 0;
+}
+
+// 按播放器任务的方式运行 ms 毫秒：process() 之后休眠到下一个期限，最长 1ms 以便及时处理中断送来的帧
+template <typename Player>
+void runFor(Player& player, const uint32_t ms) {
+    const uint64_t until = time_us_64() + static_cast<uint64_t>(ms) * 1000;
+    while (time_us_64() < until) {
+        player.process();
+        const uint32_t wait = player.msUntilDeadline();
+        uint64_t step = wait == 0 ? 100 : wait > 1 ? 1000 : static_cast<uint64_t>(wait) * 1000;
+        if (time_us_64() + step > until) {
+            step = until - time_us_64();
+        }
+        host_advance_us(step);
+    }
+    player.process();
+}
+
+// 运行到 done(player) 为真，超过 limitMs 时返回 false
+template <typename Player, typename Predicate>
+bool runUntil(Player& player, Predicate done, const uint32_t limitMs) {
+    const uint64_t until = time_us_64() + static_cast<uint64_t>(limitMs) * 1000;
+    while (!done(player)) {
+        if (time_us_64() >= until) {
+            return false;
+        }
+        runFor(player, 1);
+    }
+    return true;
+}
+
+#endif // HOST_TEST_H
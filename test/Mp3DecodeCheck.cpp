@@ -0,0 +1,78 @@
+#include <stdlib.h>
+#include "HostTest.h"
+#include "Mp3Decoder.h"
+
+// MP3 解码检查：经 FileReader 和 Mp3Decoder 完整解码命令行给出的文件，按固件送入 PCM 环的样本写成 WAV，
+// 便于在 PC 上试听或与参考解码器逐样本比较；给出期望的每声道样本数时同时检查裁剪后的长度
+namespace {
+void put16(FILE* out, const uint16_t value) {
+    const uint8_t bytes[2] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+    fwrite(bytes, 1, 2, out);
+}
+
+void put32(FILE* out, const uint32_t value) {
+    put16(out, static_cast<uint16_t>(value));
+    put16(out, static_cast<uint16_t>(value >> 16));
+}
+
+void writeHeader(FILE* out, const uint32_t rate, const uint16_t channels, const uint32_t dataBytes) {
+    fwrite("RIFF", 1, 4, out);
+    put32(out, 36 + dataBytes);
+    fwrite("WAVEfmt ", 1, 8, out);
+    put32(out, 16);
+    put16(out, 1);
+    put16(out, channels);
+    put32(out, rate);
+    put32(out, rate * channels * 2);
+    put16(out, channels * 2);
+    put16(out, 16);
+    fwrite("data", 1, 4, out);
+    put32(out, dataBytes);
+}
+}
+
+int main(const int argc, char** argv) {
+    if (argc < 3) {
+        printf("usage: Mp3DecodeCheck in.mp3 out.wav [expected samples per channel]\n");
+        return 2;
+    }
+    static FileReader reader;
+    static Mp3Decoder decoder;
+    FILE* out = fopen(argv[2], "wb");
+    EXPECT(out != nullptr);
+    EXPECT(reader.open(argv[1]));
+    if (!out || !reader.isOpen()) {
+        return testResult("Mp3DecodeCheck");
+    }
+    decoder.start(reader);
+    // 先写占位的头，解码结束后按实际长度改写
+    writeHeader(out, 0, 0, 0);
+    uint64_t frames = 0;
+    uint32_t rate = 0;
+    uint8_t channels = 0;
+    while (const uint32_t count = decoder.decode(reader)) {
+        if (channels == 0) {
+            rate = decoder.getSampleRate();
+            channels = decoder.getChannels();
+        }
+        // 码流中途改变声道数或采样率的文件固件同样不支持
+        EXPECT_EQ(decoder.getChannels(), channels);
+        EXPECT_EQ(decoder.getSampleRate(), rate);
+        const int16_t* pcm = decoder.pcm();
+        for (uint32_t i = 0; i < count * channels; i++) {
+            put16(out, static_cast<uint16_t>(pcm[i]));
+        }
+        frames += count;
+    }
+    fseek(out, 0, SEEK_SET);
+    writeHeader(out, rate, channels, static_cast<uint32_t>(frames * channels * 2));
+    fclose(out);
+    reader.close();
+    printf("%s: %u Hz, %u ch, %llu samples per channel%s\n", argv[1], rate, channels,
+           static_cast<unsigned long long>(frames), decoder.isGapless() ? ", gapless" : "");
+    EXPECT(frames > 0);
+    if (argc > 3) {
+        EXPECT_EQ(frames, strtoull(argv[3], nullptr, 10));
+    }
+    return testResult("Mp3DecodeCheck");
+}
@@ -0,0 +1,179 @@
+#include <thread>
+#include "HostTest.h"
+#include "PcmRing.h"
+
+// PcmRing 的单生产者/单消费者压力测试，按 ThreadSanitizer 构建：周期内容是普通内存，
+// 只靠 tail/head 的 release/acquire 配对保证可见，顺序写错时 TSAN 报数据竞争、内容检查报撕裂的周期。
+// 消费者模仿两个 DMA 通道：每次先归还最早取出的周期，再取下一个
+namespace {
+constexpr uint16_t FRAMES = 64;
+constexpr uint8_t PERIODS = 8;
+using Ring = PcmRing<FRAMES, PERIODS>;
+
+struct Dma {
+    const uint32_t* held[2]{};
+    uint8_t next = 0;
+
+    // 归还当前通道上的周期并取下一个，没有可读周期时返回 nullptr
+    const uint32_t* step(Ring& ring) {
+        if (held[next]) {
+            ring.release();
+            held[next] = nullptr;
+        }
+        const uint32_t* period = ring.acquireRead();
+        held[next] = period;
+        next ^= 1;
+        return period;
+    }
+
+    void drain(Ring& ring) {
+        for (const uint32_t*& period : held) {
+            if (period) {
+                ring.release();
+                period = nullptr;
+            }
+        }
+    }
+};
+
+// 周期 sequence 的第 i 帧写入 sequence * FRAMES + i
+bool intact(const uint32_t* period, uint32_t& sequence) {
+    sequence = period[0] / FRAMES;
+    for (uint16_t i = 0; i < FRAMES; i++) {
+        if (period[i] != sequence * FRAMES + i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testOrdering() {
+    static Ring ring;
+    constexpr uint32_t TOTAL = 20000;
+    std::thread producer([] {
+        uint32_t sequence = 0;
+        while (sequence < TOTAL) {
+            uint32_t* period = ring.acquireWrite();
+            if (period == nullptr) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (uint16_t i = 0; i < FRAMES; i++) {
+                period[i] = sequence * FRAMES + i;
+            }
+            ring.commit();
+            sequence++;
+        }
+    });
+    Dma dma;
+    uint32_t expected = 0;
+    uint32_t torn = 0;
+    uint32_t skipped = 0;
+    while (expected < TOTAL) {
+        const uint32_t* period = dma.step(ring);
+        if (period == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t sequence;
+        torn += !intact(period, sequence);
+        skipped += sequence != expected;
+        expected++;
+    }
+    producer.join();
+    dma.drain(ring);
+    EXPECT_EQ(torn, 0);
+    EXPECT_EQ(skipped, 0);
+    EXPECT_EQ(ring.freeFrames(), FRAMES * PERIODS);
+}
+
+// 生产者周期性地 discard()：消费者看到的周期仍然完整且严格递增，丢弃确实跳过了已发布的周期，
+// 丢弃时的 head 移动不能越过 tail，结束后环为空
+void testDiscard() {
+    static Ring ring;
+    constexpr uint32_t TOTAL = 30000;
+    std::atomic<bool> done{false};
+    std::thread producer([&done] {
+        uint32_t sequence = 0;
+        while (sequence < TOTAL) {
+            uint32_t* period = ring.acquireWrite();
+            if (period == nullptr) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (uint16_t i = 0; i < FRAMES; i++) {
+                period[i] = sequence * FRAMES + i;
+            }
+            ring.commit();
+            if (++sequence % 100 == 0) {
+                ring.discard();
+            }
+        }
+        done.store(true, std::memory_order_release);
+    });
+    Dma dma;
+    uint32_t received = 0;
+    uint32_t last = 0;
+    uint32_t torn = 0;
+    uint32_t backwards = 0;
+    while (!done.load(std::memory_order_acquire) || ring.readyPeriods() > 0) {
+        const uint32_t* period = dma.step(ring);
+        if (period == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t sequence;
+        torn += !intact(period, sequence);
+        backwards += received > 0 && sequence <= last;
+        last = sequence;
+        received++;
+    }
+    producer.join();
+    dma.drain(ring);
+    EXPECT_EQ(torn, 0);
+    EXPECT_EQ(backwards, 0);
+    EXPECT(received < TOTAL);
+    EXPECT_EQ(ring.readyPeriods(), 0);
+    EXPECT_EQ(ring.freeFrames(), FRAMES * PERIODS);
+}
+
+// 单线程检查 discard() 的语义：DMA 持有的周期归还前不丢弃、期间不输出，之后直接跳到丢弃点；
+// 丢弃之后发布的周期保留
+void testDiscardSequence() {
+    static Ring ring;
+    for (uint32_t sequence = 0; sequence < 5; sequence++) {
+        uint32_t* period = ring.acquireWrite();
+        for (uint16_t i = 0; i < FRAMES; i++) {
+            period[i] = sequence * FRAMES + i;
+        }
+        ring.commit();
+    }
+    const uint32_t* first = ring.acquireRead();
+    const uint32_t* second = ring.acquireRead();
+    EXPECT(first != nullptr && second != nullptr);
+    ring.discard();
+    uint32_t* period = ring.acquireWrite();
+    for (uint16_t i = 0; i < FRAMES; i++) {
+        period[i] = 9 * FRAMES + i;
+    }
+    ring.commit();
+    EXPECT(ring.acquireRead() == nullptr);
+    ring.release();
+    EXPECT(ring.acquireRead() == nullptr);
+    ring.release();
+    const uint32_t* next = ring.acquireRead();
+    uint32_t sequence = 0;
+    EXPECT(next != nullptr && intact(next, sequence));
+    EXPECT_EQ(sequence, 9);
+    EXPECT(ring.acquireRead() == nullptr);
+    ring.release();
+    EXPECT_EQ(ring.freeFrames(), FRAMES * PERIODS);
+}
+} // namespace
+
+int main() {
+    testOrdering();
+    testDiscard();
+    testDiscardSequence();
+    return testResult("PcmRingStressTest");
+}
@@ -0,0 +1,155 @@
+#include "HostTest.h"
+#include "PlayerTF16P.h"
+#include "TF16PEmulator.h"
+
+// 故障注入：应答丢失、回复校验错、0x40 错误帧，以及错误连发之后的状态核对
+namespace {
+struct Errors {
+    int count = 0;
+    uint16_t last = 0;
+};
+
+void onEvent(const PlayerEvent& event, void* arg) {
+    if (event.type == PlayerEventType::MODULE_ERROR) {
+        auto* errors = static_cast<Errors*>(arg);
+        errors->count++;
+        errors->last = event.value;
+    }
+}
+
+TF16PEmulator::Config quietLink() {
+    TF16PEmulator::Config config;
+    config.bootMs = 300;
+    return config;
+}
+
+// 上线并等缓存补齐，之后的链路流量只来自测试发出的命令
+void boot(PlayerTF16P& player, TF16PEmulator& emulator) {
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isReady(); }, 1000));
+    runFor(player, 1000);
+}
+
+bool settled(const PlayerTF16P& player, const CommandHandle handle) {
+    const CommandStatus status = player.status(handle);
+    return status == CommandStatus::DONE || status == CommandStatus::FAILED || status == CommandStatus::TIMEOUT;
+}
+
+void testDroppedAck() {
+    TF16PEmulator emulator(quietLink());
+    PlayerTF16P player(4, 5, uart1);
+    boot(player, emulator);
+    const PlayerStats before = player.snapshot();
+    emulator.dropReplies(1);
+    const CommandHandle volume = player.setVolume(9);
+    EXPECT(runUntil(player, [volume](const PlayerTF16P& p) { return settled(p, volume); }, 1000));
+    // 音量是幂等命令：超时后重发一次即成功
+    EXPECT(player.status(volume) == CommandStatus::DONE);
+    EXPECT_EQ(emulator.getVolume(), 9);
+    PlayerStats stats = player.snapshot();
+    EXPECT_EQ(stats.timeouts - before.timeouts, 1);
+    EXPECT_EQ(stats.retries - before.retries, 1);
+    EXPECT_EQ(stats.reconciliations, before.reconciliations);
+    // 超时的那次也计入直方图，最大值不小于超时时间
+    const LatencyHistogram& histogram = stats.histogramFor(VOLUME);
+    EXPECT_EQ(histogram.samples, 2);
+    EXPECT(histogram.maxUs >= PlayerTF16P::COMMAND_TIMEOUT_MS * 1000);
+}
+
+void testBadChecksum() {
+    TF16PEmulator emulator(quietLink());
+    PlayerTF16P player(4, 5, uart1);
+    boot(player, emulator);
+    const PlayerStats before = player.snapshot();
+    // 第一次的回复被改写，主机丢弃后按超时重发；重发前恢复链路
+    emulator.setFaults(0, 1000, 0);
+    const CommandHandle play = player.playTrack(3);
+    runFor(player, PlayerTF16P::COMMAND_TIMEOUT_MS / 2);
+    emulator.setFaults(0, 0, 0);
+    EXPECT(runUntil(player, [play](const PlayerTF16P& p) { return settled(p, play); }, 1000));
+    EXPECT(player.status(play) == CommandStatus::DONE);
+    EXPECT_EQ(player.readState().track, 3);
+    const PlayerStats stats = player.snapshot();
+    EXPECT(stats.checksumErrors > before.checksumErrors);
+    EXPECT_EQ(stats.timeouts - before.timeouts, 1);
+    EXPECT_EQ(stats.retries - before.retries, 1);
+}
+
+void testErrorFrames() {
+    TF16PEmulator emulator(quietLink());
+    PlayerTF16P player(4, 5, uart1);
+    Errors errors;
+    player.setEventHandler(onEvent, &errors);
+    boot(player, emulator);
+    const PlayerStats before = player.snapshot();
+    // 一直回复忙：重发到 MAX_ATTEMPTS 次后以错误码1失败
+    emulator.setFaults(0, 0, 1000);
+    const CommandHandle volume = player.setVolume(20);
+    EXPECT(runUntil(player, [volume](const PlayerTF16P& p) { return settled(p, volume); }, 3000));
+    EXPECT(player.status(volume) == CommandStatus::FAILED);
+    EXPECT_EQ(errors.count, PlayerTF16P::MAX_ATTEMPTS);
+    EXPECT_EQ(errors.last, 0x01);
+    const PlayerStats stats = player.snapshot();
+    EXPECT_EQ(stats.failures - before.failures, PlayerTF16P::MAX_ATTEMPTS);
+    EXPECT_EQ(stats.retries - before.retries, PlayerTF16P::MAX_ATTEMPTS - 1);
+    EXPECT_EQ(stats.timeouts, before.timeouts);
+    EXPECT(emulator.getVolume() != 20);
+}
+
+void testBurstThenReconcile() {
+    TF16PEmulator emulator(quietLink());
+    PlayerTF16P player(4, 5, uart1);
+    boot(player, emulator);
+    const PlayerStats before = player.snapshot();
+    emulator.setFaults(0, 0, 1000);
+    const CommandHandle failed = player.setVolume(5);
+    EXPECT(runUntil(player, [failed](const PlayerTF16P& p) { return settled(p, failed); }, 3000));
+    EXPECT(player.status(failed) == CommandStatus::FAILED);
+    EXPECT_EQ(player.snapshot().reconciliations, before.reconciliations);
+    // 链路恢复后第一次成功的应答触发核对，缓存按模块的实际状态重新查询
+    emulator.setFaults(0, 0, 0);
+    const CommandHandle play = player.playTrack(11);
+    EXPECT(runUntil(player, [play](const PlayerTF16P& p) { return settled(p, play); }, 1000));
+    EXPECT(player.status(play) == CommandStatus::DONE);
+    runFor(player, 1000);
+    const PlayerStats stats = player.snapshot();
+    EXPECT_EQ(stats.reconciliations - before.reconciliations, 1);
+    EXPECT(player.isIdle());
+    EXPECT_EQ(player.getVolume(), emulator.getVolume());
+    EXPECT_EQ(player.readState().track, 11);
+}
+
+// 三种故障同时以小概率出现：所有命令都要有结果，链路最终空闲，缓存与模块一致
+void testRandomFaults() {
+    TF16PEmulator emulator(quietLink());
+    PlayerTF16P player(4, 5, uart1);
+    boot(player, emulator);
+    emulator.setFaults(2, 20, 20);
+    CommandHandle last = INVALID_COMMAND;
+    for (uint8_t i = 0; i < 60; i++) {
+        last = i % 2 ? player.setVolume(static_cast<uint8_t>(i % 30)) : player.playTrack(1 + i % 40);
+        EXPECT(last != INVALID_COMMAND);
+        EXPECT(runUntil(player, [last](const PlayerTF16P& p) { return settled(p, last); }, 5000));
+    }
+    emulator.setFaults(0, 0, 0);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isIdle(); }, 5000));
+    // 上面的核对与缓存刷新在空闲时完成
+    runFor(player, 2000);
+    EXPECT(player.isIdle());
+    EXPECT_EQ(player.getVolume(), emulator.getVolume());
+}
+} // namespace
+
+int main() {
+    testDroppedAck();
+    host_clear_alarms();
+    testBadChecksum();
+    host_clear_alarms();
+    testErrorFrames();
+    host_clear_alarms();
+    testBurstThenReconcile();
+    host_clear_alarms();
+    testRandomFaults();
+    return testResult("PlayerFaultTest");
+}
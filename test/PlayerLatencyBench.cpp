@@ -0,0 +1,71 @@
+#include "HostTest.h"
+#include "PlayerTF16P.h"
+#include "TF16PEmulator.h"
+
+// 命令延迟基准：在模拟模块上测量单条命令与按键连发从调用到完成的时间（虚拟时钟），
+// 与改造前每帧固定休眠 200ms 的发送方式对比
+namespace {
+constexpr uint32_t BLOCKING_SLEEP_MS = 200;
+
+struct Result {
+    uint64_t firstUs;
+    uint64_t allUs;
+};
+
+Result burst(PlayerTF16P& player, const int presses) {
+    CommandHandle handles[PlayerTF16P::QUEUE_SIZE];
+    const uint64_t start = time_us_64();
+    uint64_t firstAt = 0;
+    for (int i = 0; i < presses; i++) {
+        // 音量与状态查询交替，避免被队尾改写合并
+        handles[i] = i % 2 ? player.setVolume(10 + i) : player.getStats();
+    }
+    while (true) {
+        int done = 0;
+        for (int i = 0; i < presses; i++) {
+            done += player.status(handles[i]) == CommandStatus::DONE;
+        }
+        if (done > 0 && firstAt == 0) {
+            firstAt = time_us_64();
+        }
+        if (done == presses || time_us_64() - start > 5000000) {
+            break;
+        }
+        runFor(player, 1);
+    }
+    return Result{firstAt - start, time_us_64() - start};
+}
+}
+
+int main() {
+    TF16PEmulator::Config config;
+    config.bootMs = 100;
+    TF16PEmulator emulator(config);
+    PlayerTF16P player(4, 5, uart1);
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isReady(); }, 2000));
+    runFor(player, 2000);
+
+    printf("presses  first done   all done   blocking (200ms/frame)\n");
+    for (const int presses : {1, 5, 10}) {
+        uint64_t first = 0;
+        uint64_t all = 0;
+        constexpr int ROUNDS = 20;
+        for (int round = 0; round < ROUNDS; round++) {
+            const Result result = burst(player, presses);
+            first += result.firstUs;
+            all += result.allUs;
+            runFor(player, 50);
+        }
+        first /= ROUNDS;
+        all /= ROUNDS;
+        const uint64_t blocking = static_cast<uint64_t>(presses) * BLOCKING_SLEEP_MS * 1000;
+        printf("%7d %9.1fms %9.1fms %12.1fms\n", presses, first / 1000.0, all / 1000.0, blocking / 1000.0);
+        // 每帧耗时为模拟器的回复延迟（20ms 加最多 5ms 抖动）与一帧传输时间，远低于固定休眠
+        EXPECT(all < blocking / 3);
+    }
+    player.dumpStats();
+    EXPECT_EQ(player.snapshot().timeouts, 0);
+    return testResult("PlayerLatencyBench");
+}
@@ -0,0 +1,187 @@
+#include "HostTest.h"
+#include "PlayerTF16P.h"
+#include "TF16PEmulator.h"
+
+namespace {
+struct Events {
+    int finished = 0;
+    int advanced = 0;
+    uint16_t last = 0;
+};
+
+void onEvent(const PlayerEvent& event, void* arg) {
+    auto* events = static_cast<Events*>(arg);
+    if (event.type == PlayerEventType::TRACK_FINISHED) {
+        events->finished++;
+    } else if (event.type == PlayerEventType::TRACK_ADVANCED) {
+        events->advanced++;
+    }
+    events->last = event.value;
+}
+
+TF16PEmulator::Config shortTracks() {
+    TF16PEmulator::Config config;
+    config.bootMs = 300;
+    config.trackMs = 2000;
+    return config;
+}
+
+void testBootAndCommands() {
+    TF16PEmulator emulator(shortTracks());
+    PlayerTF16P player(4, 5, uart1);
+    player.attach(emulator);
+    const CommandHandle select = player.begin(DeviceType::TFCARD);
+    EXPECT(player.status(select) == CommandStatus::QUEUED);
+    // 上线帧到达前不发送命令
+    runFor(player, 200);
+    EXPECT(!player.isOnline());
+    EXPECT(player.status(select) == CommandStatus::QUEUED);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isReady(); }, 1000));
+    EXPECT(player.status(select) == CommandStatus::DONE);
+
+    const CommandHandle volume = player.setVolume(12);
+    const CommandHandle play = player.playTrack(5);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isIdle(); }, 1000));
+    EXPECT(player.status(volume) == CommandStatus::DONE);
+    EXPECT(player.status(play) == CommandStatus::DONE);
+    EXPECT(player.isPlaying());
+    EXPECT_EQ(player.readState().track, 5);
+    // 缓存在空闲时补齐
+    runFor(player, 1000);
+    EXPECT_EQ(player.getTrackTotal(), 40);
+    EXPECT_EQ(player.getFolderTotal(), 4);
+    EXPECT(player.getFolderIndex().isValid());
+    const PlayerStats stats = player.snapshot();
+    EXPECT_EQ(stats.timeouts, 0);
+    EXPECT_EQ(stats.failures, 0);
+}
+
+void testTrackFinished() {
+    TF16PEmulator emulator(shortTracks());
+    PlayerTF16P player(4, 5, uart1);
+    Events events;
+    player.setEventHandler(onEvent, &events);
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isReady(); }, 1000));
+    player.playTrack(7);
+    runFor(player, 2500);
+    // 重复上报的结束帧只产生一次事件
+    EXPECT_EQ(events.finished, 1);
+    EXPECT_EQ(events.last, 7);
+    EXPECT(!player.isPlaying());
+}
+
+void testSequencing() {
+    TF16PEmulator emulator(shortTracks());
+    PlayerTF16P player(4, 5, uart1);
+    Events events;
+    player.setEventHandler(onEvent, &events);
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isReady(); }, 1000));
+    runFor(player, 500);
+    player.setSequencing(true);
+    player.playTrack(2);
+    EXPECT(player.queueNext(9));
+    runFor(player, 4500);
+    EXPECT_EQ(events.finished, 0);
+    EXPECT_EQ(events.advanced, 2);
+    EXPECT_EQ(player.getTrack(), 10);
+    EXPECT_EQ(player.snapshot().sequencedTracks, 2);
+}
+
+// 连播命令等待应答时有新命令入队：任务不能空转，命令在应答之后发出
+void testQueuedDuringArmedAck() {
+    TF16PEmulator emulator(shortTracks());
+    PlayerTF16P player(4, 5, uart1);
+    Events events;
+    player.setEventHandler(onEvent, &events);
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isReady(); }, 1000));
+    runFor(player, 500);
+    player.setSequencing(true);
+    player.playTrack(2);
+    EXPECT(runUntil(player, [&](const PlayerTF16P&) { return events.advanced == 1; }, 3000));
+    EXPECT_EQ(player.snapshot().sequencedTracks, 0);
+    const CommandHandle volume = player.setVolume(7);
+    player.process();
+    const uint32_t wait = player.msUntilDeadline();
+    EXPECT(wait > 0 && wait <= PlayerTF16P::COMMAND_TIMEOUT_MS);
+    EXPECT(player.status(volume) == CommandStatus::QUEUED);
+    EXPECT(runUntil(player, [&](const PlayerTF16P& p) { return p.status(volume) == CommandStatus::DONE; }, 1000));
+    EXPECT_EQ(player.snapshot().sequencedTracks, 1);
+    EXPECT_EQ(player.snapshot().timeouts, 0);
+}
+
+// 文件夹循环：模块自行续播，驱动不上报结束、不停止计时，也不会被任务的补发命令打断
+void testLoopFolder() {
+    TF16PEmulator emulator(shortTracks());
+    PlayerTF16P player(4, 5, uart1);
+    Events events;
+    player.setEventHandler(onEvent, &events);
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.getFolderIndex().isValid(); }, 2000));
+    player.setSequencing(true);
+    player.loopFolder(2);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isIdle() && p.isPlaying(); }, 1000));
+    EXPECT(player.isLooping());
+    EXPECT_EQ(player.getTrack(), 11);
+    const uint32_t received = emulator.getFramesReceived();
+    // 第10首之后回到文件夹第一首
+    runFor(player, 2000 * 11 + 500);
+    EXPECT_EQ(events.finished, 0);
+    EXPECT_EQ(events.advanced, 11);
+    EXPECT_EQ(player.getTrack(), 12);
+    EXPECT(player.isPlaying());
+    EXPECT(player.getPositionMs() > 0);
+    // 期间只有缓存刷新的查询，没有播放命令
+    EXPECT(player.snapshot().sequencedTracks == 0);
+    EXPECT(emulator.getFramesReceived() - received < 11);
+}
+
+// 中断未能连播时的补发与中断使用同一顺序：先取待播列表
+void onFinishedPlayNext(const PlayerEvent& event, void* arg) {
+    auto* player = static_cast<PlayerTF16P*>(arg);
+    if (event.type == PlayerEventType::TRACK_FINISHED) {
+        player->playNext();
+    }
+}
+
+void testPlayNextFollowsPlaylist() {
+    TF16PEmulator emulator(shortTracks());
+    PlayerTF16P player(4, 5, uart1);
+    player.setEventHandler(onFinishedPlayNext, &player);
+    player.attach(emulator);
+    player.begin(DeviceType::TFCARD);
+    EXPECT(runUntil(player, [](const PlayerTF16P& p) { return p.isReady(); }, 1000));
+    runFor(player, 500);
+    player.playTrack(2);
+    EXPECT(player.queueNext(9));
+    EXPECT(player.queueNext(4));
+    runFor(player, 2500);
+    EXPECT_EQ(player.getTrack(), 9);
+    runFor(player, 2100);
+    EXPECT_EQ(player.getTrack(), 4);
+    runFor(player, 2100);
+    EXPECT_EQ(player.getTrack(), 5);
+    EXPECT(player.isPlaying());
+}
+}
+
+int main() {
+    testBootAndCommands();
+    host_clear_alarms();
+    testTrackFinished();
+    host_clear_alarms();
+    testSequencing();
+    host_clear_alarms();
+    testQueuedDuringArmedAck();
+    host_clear_alarms();
+    testLoopFolder();
+    host_clear_alarms();
+    testPlayNextFollowsPlaylist();
+    return testResult("PlayerTF16PTest");
+}
@@ -0,0 +1,48 @@
+#include "HostTest.h"
+#include "QueryCache.h"
+
+namespace {
+void testInvalidEntriesFirst() {
+    QueryCache cache;
+    TF16PFrame frame{};
+    EXPECT_EQ(cache.nextQuery(1, frame), 0);
+    EXPECT_EQ(frame.command(), TOTAL_TFCARD);
+}
+
+void testOnlyReadEntriesRefresh() {
+    QueryCache cache;
+    const uint64_t now = 1000;
+    cache.trackTotal[1].set(40, now);
+    cache.status.set(0x0201, now);
+    cache.currentTrack.set(3, now);
+    cache.volume.set(20, now);
+    cache.folderTotal.set(2, now);
+    cache.folderFiles[0].set(10, now);
+    cache.folderFiles[1].set(30, now);
+    TF16PFrame frame{};
+    EXPECT(cache.nextQuery(1, frame) == UINT64_MAX);
+    // 读取过的值在过期后刷新
+    EXPECT_EQ(cache.volume.get(), 20);
+    EXPECT_EQ(cache.nextQuery(1, frame), now + QueryCache::STATUS_TTL_MS * 1000);
+    EXPECT_EQ(frame.command(), QUERY_VOLUME);
+    cache.volume.set(21, now + 1);
+    EXPECT(cache.nextQuery(1, frame) == UINT64_MAX);
+}
+
+void testEntryFor() {
+    QueryCache cache;
+    EXPECT(cache.entryFor(makeFrame(TOTAL_FLASH), 1) == &cache.trackTotal[2]);
+    EXPECT(cache.entryFor(makeFrame(TRACK_TFCARD), 1) == &cache.currentTrack);
+    EXPECT(cache.entryFor(makeFrame(TRACK_UDISK), 1) == nullptr);
+    EXPECT(cache.entryFor(makeFrame(FOLDER_FILES, 3), 1) == &cache.folderFiles[2]);
+    EXPECT(cache.entryFor(makeFrame(FOLDER_FILES, 0), 1) == nullptr);
+    EXPECT(cache.entryFor(makeFrame(PLAY, 1), 1) == nullptr);
+}
+}
+
+int main() {
+    testInvalidEntriesFirst();
+    testOnlyReadEntriesRefresh();
+    testEntryFor();
+    return testResult("QueryCacheTest");
+}
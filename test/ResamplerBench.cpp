@@ -0,0 +1,70 @@
+#include <chrono>
+#include <math.h>
+#include "HostTest.h"
+#include "Resampler.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 采样率转换的吞吐：48kHz 与 22.05kHz 的立体声按解码器的段长送入，报告每个输出样本的耗时/周期数
+// 和相对实时播放的倍数。主机上的数字只用来比较两种比例的相对开销
+namespace {
+constexpr uint16_t FRAMES = 1152;
+constexpr uint32_t SECONDS = 20;
+int16_t source[FRAMES * 2];
+
+uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// 输出只计数，不计入复制的开销
+void count(const int16_t* samples, const uint32_t frames, void* arg) {
+    (void)samples;
+    *static_cast<uint64_t*>(arg) += frames;
+}
+
+struct Throughput {
+    double ns;
+    double cycles;
+    double realtime;
+};
+
+Throughput measure(const uint32_t inputRate) {
+    static Resampler resampler;
+    EXPECT(resampler.configure(inputRate));
+    const uint32_t periods = inputRate * SECONDS / FRAMES;
+    uint64_t produced = 0;
+    const uint64_t startCycles = cycles();
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t p = 0; p < periods; p++) {
+        resampler.process(source, FRAMES, 2, count, &produced);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    const double spentCycles = static_cast<double>(cycles() - startCycles);
+    const double audioNs = static_cast<double>(periods) * FRAMES * 1e9 / inputRate;
+    const double samples = static_cast<double>(produced) * 2;
+    EXPECT(produced > 0);
+    return {ns / samples, spentCycles / samples, audioNs / ns};
+}
+}
+
+int main() {
+    for (uint16_t i = 0; i < FRAMES; i++) {
+        source[i * 2] = static_cast<int16_t>(lround(9000.0 * sin(i * 0.0137) + 3000.0 * sin(i * 0.71)));
+        source[i * 2 + 1] = static_cast<int16_t>(lround(9000.0 * sin(i * 0.0191) - 3000.0 * sin(i * 0.53)));
+    }
+    printf("resampler          ns/sample  cycles/sample  x realtime\n");
+    const uint32_t rates[] = {48000, 22050};
+    for (const uint32_t rate : rates) {
+        const Throughput result = measure(rate);
+        printf("%5u -> 44100     %8.2f       %8.1f    %8.0f\n", rate, result.ns, result.cycles, result.realtime);
+        // 量级检查：64 抽头每输出样本约64次乘加，未优化的主机构建也远快于实时
+        EXPECT(result.ns < 1000.0);
+        EXPECT(result.realtime > 10.0);
+    }
+    return testResult("ResamplerBench");
+}
@@ -0,0 +1,173 @@
+#include <math.h>
+#include "HostTest.h"
+#include "Resampler.h"
+
+// 采样率转换的频率响应：通带内的正弦原样通过；48kHz 输入中高于输出奈奎斯特频率的分量（20–24kHz 扫频）
+// 混叠到 44.1kHz - f，22.05kHz 输入的 f 在输出中的镜像在 22.05kHz - f，两者都必须低于 ALIAS_FLOOR_DB；
+// 通带内单音的 THD+N（去掉基波后全频带的残差）低于 THD_N_DB
+namespace {
+constexpr uint32_t FRAMES = 44100;
+constexpr uint32_t SETTLE = 1024;
+constexpr double AMPLITUDE = 16000.0;
+constexpr double ALIAS_FLOOR_DB = -75.0;
+constexpr double THD_N_DB = -72.0;
+int16_t input[FRAMES * 2];
+
+struct Capture {
+    uint32_t frames = 0;
+    int16_t left[FRAMES * 2];
+};
+
+void collect(const int16_t* samples, const uint32_t frames, void* arg) {
+    auto* capture = static_cast<Capture*>(arg);
+    for (uint32_t i = 0; i < frames; i++) {
+        capture->left[capture->frames++] = samples[i * 2];
+    }
+}
+
+Capture capture;
+
+// 把 inputRate 下一秒长的 toneHz 正弦送入转换器，输出的左声道留在 capture 中
+void resample(const uint32_t inputRate, const double toneHz) {
+    static Resampler resampler;
+    EXPECT(resampler.configure(inputRate));
+    const uint32_t frames = inputRate < FRAMES ? inputRate : FRAMES;
+    for (uint32_t i = 0; i < frames; i++) {
+        const auto sample = static_cast<int16_t>(lround(AMPLITUDE * sin(2.0 * M_PI * toneHz * i / inputRate)));
+        input[i * 2] = sample;
+        input[i * 2 + 1] = sample;
+    }
+    capture.frames = 0;
+    resampler.process(input, frames, 2, collect, &capture);
+}
+
+// 输出中 measureHz 分量相对输入幅度的 dB 数。
+// 跳过开头的建立过程，加 Hann 窗后单点 DFT，相距100Hz的满幅分量泄漏到 -100dB 以下
+double level(const uint32_t inputRate, const double toneHz, const double measureHz) {
+    resample(inputRate, toneHz);
+    const uint32_t count = capture.frames - SETTLE;
+    double real = 0.0;
+    double imaginary = 0.0;
+    double gain = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        const double window = 0.5 - 0.5 * cos(2.0 * M_PI * i / count);
+        const double angle = 2.0 * M_PI * measureHz * i / Resampler::OUTPUT_RATE;
+        const double sample = capture.left[SETTLE + i] * window;
+        real += sample * cos(angle);
+        imaginary += sample * sin(angle);
+        gain += window;
+    }
+    const double amplitude = 2.0 * sqrt(real * real + imaginary * imaginary) / gain;
+    return 20.0 * log10((amplitude > 0.0 ? amplitude : 1e-3) / AMPLITUDE);
+}
+
+void expectPassband(const uint32_t inputRate, const double frequencyHz) {
+    const double db = level(inputRate, frequencyHz, frequencyHz);
+    if (fabs(db) > 0.1) {
+        printf("%u Hz input, %.0f Hz: %.2f dB in passband\n", inputRate, frequencyHz, db);
+        testFailures()++;
+    }
+}
+
+void expectRejected(const uint32_t inputRate, const double toneHz, const double aliasHz) {
+    const double db = level(inputRate, toneHz, aliasHz);
+    if (db > ALIAS_FLOOR_DB) {
+        printf("%u Hz input, %.0f Hz: %.1f dB at %.0f Hz, floor %.0f dB\n", inputRate, toneHz, db, aliasHz,
+               ALIAS_FLOOR_DB);
+        testFailures()++;
+    }
+}
+
+// THD+N：按最小二乘拟合出输出中 toneHz 的正弦（连同直流）并减去，剩余的谐波、混叠与量化噪声
+// 在整个 0–22.05kHz 上的能量相对基波能量的 dB 数
+double thdN(const uint32_t inputRate, const double toneHz) {
+    resample(inputRate, toneHz);
+    const uint32_t count = capture.frames - SETTLE;
+    const int16_t* x = capture.left + SETTLE;
+    double mean = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        mean += x[i];
+    }
+    mean /= count;
+    double cc = 0.0, ss = 0.0, cs = 0.0, xc = 0.0, xs = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        const double angle = 2.0 * M_PI * toneHz * i / Resampler::OUTPUT_RATE;
+        const double c = cos(angle);
+        const double s = sin(angle);
+        cc += c * c;
+        ss += s * s;
+        cs += c * s;
+        xc += (x[i] - mean) * c;
+        xs += (x[i] - mean) * s;
+    }
+    const double det = cc * ss - cs * cs;
+    const double a = (xc * ss - xs * cs) / det;
+    const double b = (xs * cc - xc * cs) / det;
+    double signal = 0.0;
+    double residual = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        const double angle = 2.0 * M_PI * toneHz * i / Resampler::OUTPUT_RATE;
+        const double fundamental = a * cos(angle) + b * sin(angle);
+        const double error = x[i] - mean - fundamental;
+        signal += fundamental * fundamental;
+        residual += error * error;
+    }
+    return 10.0 * log10(residual / signal);
+}
+
+// 48kHz -> 44.1kHz：20–24kHz 每250Hz一档，打印过渡带的衰减，输出奈奎斯特频率以上的检查混叠
+void testDownsampleSweep() {
+    printf("48000 -> 44100   input     level    alias\n");
+    for (double frequency = 20000.0; frequency < 24000.0; frequency += 250.0) {
+        const double alias = Resampler::OUTPUT_RATE - frequency;
+        const bool aliased = frequency > Resampler::OUTPUT_RATE / 2.0;
+        printf("                %5.0f Hz  %6.1f dB", frequency, level(48000, frequency, aliased ? alias : frequency));
+        printf(aliased ? "  %5.0f Hz\n" : "\n", alias);
+        if (aliased) {
+            expectRejected(48000, frequency, alias);
+        }
+    }
+    expectRejected(48000, 23900.0, Resampler::OUTPUT_RATE - 23900.0);
+    expectPassband(48000, 1000.0);
+    expectPassband(48000, 15000.0);
+    expectPassband(48000, 18000.0);
+}
+
+// 22.05kHz -> 44.1kHz：通带内的音调在 22.05kHz - f 处的镜像
+void testUpsampleImages() {
+    expectPassband(22050, 1000.0);
+    expectPassband(22050, 7500.0);
+    const double tones[] = {1000.0, 5000.0, 9000.0, 10000.0};
+    for (const double frequency : tones) {
+        expectRejected(22050, frequency, 22050.0 - frequency);
+    }
+}
+
+// 通带内的单音经转换后 THD+N 不高于 THD_N_DB。输入输出两次16位量化只占约 -92dB，
+// 残差主要是各镜像经约 -80dB 的阻带后折回通带的部分，低频单音的镜像最多，约 -75dB
+void testThdN() {
+    const uint32_t rates[] = {48000, 22050};
+    const double tones[] = {997.0, 6000.0, 15000.0};
+    printf("THD+N            input     THD+N\n");
+    for (const uint32_t rate : rates) {
+        for (const double frequency : tones) {
+            if (frequency >= rate * 0.45) {
+                continue;
+            }
+            const double db = thdN(rate, frequency);
+            printf("%5u -> 44100  %5.0f Hz  %6.1f dB\n", rate, frequency, db);
+            if (db > THD_N_DB) {
+                printf("%u Hz input, %.0f Hz: THD+N %.1f dB, limit %.0f dB\n", rate, frequency, db, THD_N_DB);
+                testFailures()++;
+            }
+        }
+    }
+}
+} // namespace
+
+int main() {
+    testDownsampleSweep();
+    testUpsampleImages();
+    testThdN();
+    return testResult("ResamplerTest");
+}
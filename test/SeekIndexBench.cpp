@@ -0,0 +1,163 @@
+#include <chrono>
+#include <stdlib.h>
+#include <vector>
+#include "HostTest.h"
+#include "FatImage.h"
+#include "SeekIndex.h"
+
+// MP3 定位基准：在内存中的 FAT16 映像上经真实的 FatFs 读取没有 Xing/VBRI 目录的 VBR 文件（5–60分钟，32–64kbps），
+// 随文件长度对比三种情况：没有索引时的首次远距离定位（线性扫描帧头）、后台扫描建立整首索引的总开销、
+// 载入 .IDX 后的随机定位。报告读命令数、扇区数、主机耗时，以及按 25MHz SPI 估算的 SD 卡耗时。
+// 映像每簇8KB，FileReader 建立了簇链映射（FF_USE_FASTSEEK）
+namespace {
+constexpr uint32_t IMAGE_SECTORS = 131072; // 64MB
+constexpr uint16_t RANDOM_SEEKS = 200;
+// SD 卡估算：每条读命令约0.2ms 的访问延迟，每个扇区 512 x 8 / 25MHz 约0.17ms
+constexpr double COMMAND_MS = 0.2;
+constexpr double SECTOR_MS = 512.0 * 8 / 25000.0;
+constexpr uint16_t BITRATES[] = {0, 32, 40, 48, 56, 64};
+
+struct Track {
+    const char* path;
+    uint32_t minutes;
+    std::vector<uint32_t> offsets; // 每帧的起点
+};
+
+// MPEG1 Layer III 44.1kHz 的帧，比特率与填充随机；负载不含 0xFF，不会被误判为帧头
+bool writeTrack(Track& track) {
+    FIL file{};
+    if (f_open(&file, track.path, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) {
+        return false;
+    }
+    const uint32_t frames = track.minutes * 60 * 44100 / 1152;
+    std::vector<uint8_t> chunk;
+    uint32_t offset = 0;
+    bool written = true;
+    for (uint32_t i = 0; i < frames && written; i++) {
+        const uint8_t index = 1 + rand() % 5;
+        const uint8_t padding = rand() % 2;
+        const uint32_t bytes = 144 * BITRATES[index] * 1000 / 44100 + padding;
+        track.offsets.push_back(offset);
+        chunk.push_back(0xFF);
+        chunk.push_back(0xFB);
+        chunk.push_back(static_cast<uint8_t>(index << 4 | padding << 1));
+        chunk.push_back(0x44);
+        for (uint32_t b = 4; b < bytes; b++) {
+            chunk.push_back(static_cast<uint8_t>(rand() & 0x7F));
+        }
+        offset += bytes;
+        if (chunk.size() >= 16384 || i + 1 == frames) {
+            UINT count = 0;
+            written = f_write(&file, chunk.data(), chunk.size(), &count) == FR_OK && count == chunk.size();
+            chunk.clear();
+        }
+    }
+    return f_close(&file) == FR_OK && written;
+}
+
+struct Cost {
+    uint64_t commands = 0;
+    uint64_t sectors = 0;
+    double hostUs = 0.0;
+
+    [[nodiscard]] double sdMs() const {
+        return commands * COMMAND_MS + sectors * SECTOR_MS;
+    }
+};
+
+template <typename Work>
+Cost measure(Work work) {
+    const FatImage::Counters before = FatImage::counters();
+    const auto start = std::chrono::steady_clock::now();
+    work();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return {FatImage::counters().readCommands - before.readCommands,
+            FatImage::counters().sectorsRead - before.sectorsRead,
+            std::chrono::duration<double, std::micro>(elapsed).count()};
+}
+
+// 定位到第 frame 帧，检查落点与实际帧起点一致
+bool seekExactly(SeekIndex& index, FileReader& reader, const Track& track, const uint32_t frame) {
+    uint32_t landed = 0;
+    return index.seek(reader, frame, landed) && landed == frame && reader.tell() == track.offsets[frame];
+}
+
+void bench(Track& track) {
+    static FileReader reader;
+    static FileReader scanner;
+    static SeekIndex index;
+    const uint32_t frames = track.offsets.size();
+    const uint32_t far = frames * 9 / 10;
+
+    // 没有索引：90%处的首次定位逐帧扫描帧头
+    EXPECT(reader.open(track.path));
+    index.begin(reader, track.path);
+    EXPECT(index.isUsable());
+    bool exact = false;
+    const Cost cold = measure([&] { exact = seekExactly(index, reader, track, far); });
+    EXPECT(exact);
+    index.close();
+
+    // 后台扫描：按解码任务的步长在另一个读取器上扫完整首，扫完后保存 .IDX
+    reader.open(track.path);
+    index.begin(reader, track.path);
+    uint32_t steps = 0;
+    const Cost build = measure([&] {
+        while (index.extend(scanner, 32)) {
+            steps++;
+        }
+    });
+    EXPECT(!scanner.isOpen());
+    index.close();
+
+    // 载入 .IDX 后的随机定位
+    reader.open(track.path);
+    uint32_t misses = 0;
+    const Cost load = measure([&] { index.begin(reader, track.path); });
+    Cost worst;
+    const Cost total = measure([&] {
+        for (uint16_t i = 0; i < RANDOM_SEEKS; i++) {
+            const uint32_t frame = static_cast<uint32_t>(rand()) % frames;
+            const Cost one = measure([&] { misses += !seekExactly(index, reader, track, frame); });
+            worst = one.sdMs() > worst.sdMs() ? one : worst;
+        }
+    });
+    EXPECT_EQ(misses, 0);
+    index.close();
+    reader.close();
+
+    printf("%3u min %5.1fMB %6u frames\n", track.minutes, track.offsets.back() / 1e6, frames);
+    printf("  cold seek to 90%%      %6llu cmd %7llu sectors %9.0fus host %8.1fms SD\n",
+           static_cast<unsigned long long>(cold.commands), static_cast<unsigned long long>(cold.sectors),
+           cold.hostUs, cold.sdMs());
+    printf("  background build      %6llu cmd %7llu sectors %9.0fus host %8.1fms SD (%u steps)\n",
+           static_cast<unsigned long long>(build.commands), static_cast<unsigned long long>(build.sectors),
+           build.hostUs, build.sdMs(), steps);
+    printf("  load .IDX             %6llu cmd %7llu sectors %9.0fus host %8.1fms SD\n",
+           static_cast<unsigned long long>(load.commands), static_cast<unsigned long long>(load.sectors),
+           load.hostUs, load.sdMs());
+    printf("  indexed seek (mean)   %6.1f cmd %7.1f sectors %9.1fus host %8.2fms SD\n",
+           static_cast<double>(total.commands) / RANDOM_SEEKS, static_cast<double>(total.sectors) / RANDOM_SEEKS,
+           total.hostUs / RANDOM_SEEKS, total.sdMs() / RANDOM_SEEKS);
+    printf("  indexed seek (worst)  %6llu cmd %7llu sectors %9.0fus host %8.2fms SD\n",
+           static_cast<unsigned long long>(worst.commands), static_cast<unsigned long long>(worst.sectors),
+           worst.hostUs, worst.sdMs());
+    // 有簇链映射时 f_lseek 不读 FAT；建立索引后的定位读入一次缓冲区（32个扇区），再跳过至多 stride - 1 个帧头，
+    // 60分钟的文件步长为128帧（约24KB），最多再补一次缓冲区。与文件长度无关，远少于线性扫描
+    EXPECT(worst.sectors <= 2 * FileReader::BUFFER_SIZE / 512 + 16);
+    EXPECT(worst.sectors * 20 < cold.sectors);
+}
+} // namespace
+
+int main() {
+    EXPECT(FatImage::format(IMAGE_SECTORS));
+    Track tracks[] = {{"T05.MP3", 5, {}}, {"T15.MP3", 15, {}}, {"T30.MP3", 30, {}}, {"T60.MP3", 60, {}}};
+    srand(1);
+    for (Track& track : tracks) {
+        EXPECT(writeTrack(track));
+    }
+    for (Track& track : tracks) {
+        bench(track);
+    }
+    return testResult("SeekIndexBench");
+}
@@ -0,0 +1,103 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "HostTest.h"
+#include "PlayerTF16P.h"
+
+// 状态快照的争用基准：一个写者线程不停发布 PlayerState，多个读者线程同时读取。
+// 对比双缓冲顺序锁与互斥锁保护的同一结构体的读取吞吐，并检查读者从未读到不一致的快照
+namespace {
+constexpr int RUN_MS = 300;
+
+PlayerState makeState(const uint32_t n) {
+    PlayerState state{};
+    state.track = n & 0xFFFF;
+    state.volume = (n ^ 0x55AA) & 0xFFFF;
+    state.playing = n & 1;
+    state.ready = true;
+    state.device = DeviceType::TFCARD;
+    state.error = (n >> 16) & 0xFFFF;
+    state.position.start(n, n);
+    return state;
+}
+
+bool consistent(const PlayerState& state) {
+    const uint32_t n = state.position.getDurationMs();
+    return state.track == (n & 0xFFFF) && state.volume == ((n ^ 0x55AA) & 0xFFFF) && state.playing == (n & 1) &&
+           state.error == ((n >> 16) & 0xFFFF);
+}
+
+struct Result {
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t torn;
+};
+
+// read 与 publish 由调用者提供，分别在读者和写者线程中执行
+template <typename Read, typename Publish>
+Result contend(const int readers, Read read, Publish publish) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> torn{0};
+    uint64_t writes = 0;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; i++) {
+        threads.emplace_back([&] {
+            uint64_t count = 0;
+            uint64_t bad = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                bad += !consistent(read());
+                count++;
+            }
+            reads += count;
+            torn += bad;
+        });
+    }
+    std::thread writer([&] {
+        uint32_t n = 1;
+        while (!stop.load(std::memory_order_relaxed)) {
+            publish(makeState(n++));
+        }
+        writes = n - 1;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(RUN_MS));
+    stop = true;
+    writer.join();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return Result{reads.load(), writes, torn.load()};
+}
+}
+
+int main() {
+    printf("readers  latch reads/s  retries/read  mutex reads/s  latch writes/s  mutex writes/s\n");
+    for (const int readers : {1, 2, 4}) {
+        StateLatch<PlayerState> latch;
+        latch.publish(makeState(0));
+        const Result lockFree = contend(readers, [&] { return latch.read(); },
+                                        [&](const PlayerState& state) { latch.publish(state); });
+        std::mutex mutex;
+        PlayerState shared = makeState(0);
+        const Result locked = contend(
+            readers,
+            [&] {
+                std::lock_guard<std::mutex> guard(mutex);
+                return shared;
+            },
+            [&](const PlayerState& state) {
+                std::lock_guard<std::mutex> guard(mutex);
+                shared = state;
+            });
+        const double seconds = RUN_MS / 1000.0;
+        printf("%7d %14.0f %13.4f %14.0f %15.0f %15.0f\n", readers, lockFree.reads / seconds,
+               lockFree.reads ? static_cast<double>(latch.getRetries()) / lockFree.reads : 0.0, locked.reads / seconds,
+               lockFree.writes / seconds, locked.writes / seconds);
+        EXPECT_EQ(lockFree.torn, 0);
+        EXPECT_EQ(locked.torn, 0);
+        EXPECT(lockFree.reads > 0);
+    }
+    return testResult("StateLatchBench");
+}
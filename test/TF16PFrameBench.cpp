@@ -0,0 +1,74 @@
+#include <chrono>
+#include <string.h>
+#include "HostTest.h"
+#include "TF16PFrame.h"
+
+// 帧构造的每条命令 CPU 开销：改造前逐字节求校验和写入共享缓冲区，改造后固定帧直接复制、
+// 带参数的帧从模板修补参数和校验和。两种方式对所有参数生成的帧必须逐字节相同
+namespace {
+constexpr int ITERATIONS = 20000000;
+
+// 改造前的 PlayerTF16P::writeFrame
+void writeFrame(uint8_t* command, const uint8_t cmd, const uint16_t arg) {
+    command[0] = 0x7E;
+    command[1] = 0xFF;
+    command[2] = 0x06;
+    command[3] = cmd;
+    command[4] = isQueryCommand(cmd) ? 0x00 : 0x01;
+    command[5] = (arg & 0xFF00) >> 8;
+    command[6] = arg & 0x00FF;
+    uint16_t checksum = 0;
+    for (int i = 1; i < 7; i++) {
+        checksum += command[i];
+    }
+    checksum = ~checksum + 1;
+    command[7] = (checksum & 0xFF00) >> 8;
+    command[8] = checksum & 0x00FF;
+    command[9] = 0xEF;
+}
+
+template <typename Build>
+double nsPerFrame(Build build) {
+    volatile uint8_t sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        TF16PFrame frame;
+        // 参数取自易变量，防止整段循环在编译期算完
+        build(frame, static_cast<uint16_t>(i + sink));
+        sink = frame.bytes[8];
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS;
+}
+
+void testSameBytes() {
+    for (uint32_t arg = 0; arg <= 0xFFFF; arg++) {
+        uint8_t before[10];
+        writeFrame(before, VOLUME, arg);
+        TF16PFrame after = TF16PFrames::VOLUME_TEMPLATE;
+        patchArgument(after, arg);
+        EXPECT(memcmp(before, after.bytes, 10) == 0);
+    }
+    uint8_t stop[10];
+    writeFrame(stop, STOP, 0);
+    EXPECT(memcmp(stop, TF16PFrames::STOP_FRAME.bytes, 10) == 0);
+    uint8_t stat[10];
+    writeFrame(stat, STAT, 0);
+    EXPECT(memcmp(stat, TF16PFrames::STAT_FRAME.bytes, 10) == 0);
+}
+}
+
+int main() {
+    testSameBytes();
+    const double loopFixed = nsPerFrame([](TF16PFrame& frame, uint16_t) { writeFrame(frame.bytes, STOP, 0); });
+    const double loopArg = nsPerFrame([](TF16PFrame& frame, const uint16_t arg) { writeFrame(frame.bytes, PLAY, arg); });
+    const double constFixed = nsPerFrame([](TF16PFrame& frame, uint16_t) { frame = TF16PFrames::STOP_FRAME; });
+    const double patched = nsPerFrame([](TF16PFrame& frame, const uint16_t arg) {
+        frame = TF16PFrames::PLAY_TEMPLATE;
+        patchArgument(frame, arg);
+    });
+    printf("frame build       before (loop)   after\n");
+    printf("fixed (STOP)      %8.2fns    %8.2fns (constexpr copy)\n", loopFixed, constFixed);
+    printf("argument (PLAY)   %8.2fns    %8.2fns (template + patch)\n", loopArg, patched);
+    return testResult("TF16PFrameBench");
+}
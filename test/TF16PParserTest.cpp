@@ -0,0 +1,166 @@
+#include "HostTest.h"
+#include <stdlib.h>
+#include <string.h>
+#include "TF16PParser.h"
+
+namespace {
+// 逐字节送入，返回完整帧的个数，帧依次写入 out
+int feed(TF16PParser& parser, const uint8_t* data, const size_t length, TF16PFrame* out = nullptr) {
+    int frames = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (parser.push(data[i])) {
+            if (out) {
+                out[frames] = parser.frame();
+            }
+            frames++;
+        }
+    }
+    return frames;
+}
+
+void testSingleFrame() {
+    TF16PParser parser;
+    const TF16PFrame frame = makeFrame(ACK, 0, 0x00);
+    TF16PFrame out[1];
+    EXPECT_EQ(feed(parser, frame.bytes, sizeof(frame.bytes), out), 1);
+    EXPECT_EQ(out[0].command(), ACK);
+    EXPECT_EQ(parser.getChecksumErrors(), 0);
+    EXPECT_EQ(parser.getDiscardedBytes(), 0);
+}
+
+void testSplitAcrossCalls() {
+    TF16PParser parser;
+    const TF16PFrame frame = makeFrame(QUERY_VOLUME, 17, 0x00);
+    EXPECT_EQ(feed(parser, frame.bytes, 4), 0);
+    TF16PFrame out[1];
+    EXPECT_EQ(feed(parser, frame.bytes + 4, 6, out), 1);
+    EXPECT_EQ(out[0].argument(), 17);
+}
+
+void testGarbageBeforeFrame() {
+    TF16PParser parser;
+    const uint8_t garbage[] = {0x00, 0xEF, 0x7E, 0x12, 0xFF, 0x06, 0x7E, 0xFF};
+    const TF16PFrame frame = makeFrame(STAT, 0x0201, 0x00);
+    EXPECT_EQ(feed(parser, garbage, sizeof(garbage)), 0);
+    TF16PFrame out[1];
+    EXPECT_EQ(feed(parser, frame.bytes, sizeof(frame.bytes), out), 1);
+    EXPECT_EQ(out[0].argument(), 0x0201);
+    EXPECT_EQ(parser.getDiscardedBytes(), sizeof(garbage));
+}
+
+void testEmbeddedHeaderBytes() {
+    // 命令字、参数和校验和中的 0x7E/0xFF/0x06 不影响解析
+    TF16PParser parser;
+    const TF16PFrame frames[] = {makeFrame(0x7E, 0x7EFF, 0x00), makeFrame(0x06, 0xFF06, 0x01),
+                                 makeFrame(FOLDER_FILES, 0x7E7E, 0x00)};
+    for (const TF16PFrame& frame : frames) {
+        TF16PFrame out[1];
+        EXPECT_EQ(feed(parser, frame.bytes, sizeof(frame.bytes), out), 1);
+        EXPECT(memcmp(out[0].bytes, frame.bytes, sizeof(frame.bytes)) == 0);
+    }
+    EXPECT_EQ(parser.getDiscardedBytes(), 0);
+}
+
+void testBadChecksum() {
+    TF16PParser parser;
+    TF16PFrame bad = makeFrame(ACK, 0, 0x00);
+    bad.bytes[8] ^= 0x01;
+    const TF16PFrame good = makeFrame(QUERY_VOLUME, 20, 0x00);
+    EXPECT_EQ(feed(parser, bad.bytes, sizeof(bad.bytes)), 0);
+    EXPECT_EQ(parser.getChecksumErrors(), 1);
+    TF16PFrame out[1];
+    EXPECT_EQ(feed(parser, good.bytes, sizeof(good.bytes), out), 1);
+    EXPECT_EQ(out[0].command(), QUERY_VOLUME);
+}
+
+void testHeaderInsideRejectedFrame() {
+    // 截断的帧后紧跟完整帧：新帧的帧头落在被拒绝帧的数据区末尾，两帧都不能丢
+    const TF16PFrame first = makeFrame(ACK, 0, 0x00);
+    const TF16PFrame second = makeFrame(TRACK_TFCARD, 3, 0x00);
+    for (uint8_t cut = 1; cut < 10; cut++) {
+        TF16PParser parser;
+        // 截断的部分加两个完整帧，最长 9 + 20 字节
+        uint8_t stream[sizeof(TF16PFrame::bytes) * 3];
+        memcpy(stream, first.bytes, cut);
+        memcpy(stream + cut, second.bytes, 10);
+        memcpy(stream + cut + 10, first.bytes, 10);
+        TF16PFrame out[2];
+        EXPECT_EQ(feed(parser, stream, cut + 20, out), 2);
+        EXPECT_EQ(out[0].command(), TRACK_TFCARD);
+        EXPECT_EQ(out[1].command(), ACK);
+    }
+}
+
+void testBackToBackFrames() {
+    TF16PParser parser;
+    uint8_t stream[40];
+    for (int i = 0; i < 4; i++) {
+        const TF16PFrame frame = makeFrame(ACK + i % 2, i, 0x00);
+        memcpy(stream + i * 10, frame.bytes, 10);
+    }
+    TF16PFrame out[4];
+    EXPECT_EQ(feed(parser, stream, sizeof(stream), out), 4);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(out[i].argument(), i);
+    }
+    EXPECT_EQ(parser.getDiscardedBytes(), 0);
+}
+
+bool validAt(const uint8_t* bytes) {
+    uint16_t sum = 0;
+    for (int i = 1; i < 7; i++) {
+        sum += bytes[i];
+    }
+    return bytes[0] == 0x7E && bytes[1] == 0xFF && bytes[2] == 0x06 && bytes[9] == 0xEF &&
+           static_cast<uint16_t>(sum + (bytes[7] << 8 | bytes[8])) == 0;
+}
+
+// 随机拼接帧头字节、截断帧和完整帧，与逐位置检查的参考扫描比较：解析出的帧必须与从左到右不重叠的有效帧完全一致
+void testReplayMatchesScan() {
+    static const uint8_t alphabet[] = {0x7E, 0xFF, 0x06, 0xEF, 0x00, 0x01, 0x41};
+    srand(2);
+    for (int round = 0; round < 20000; round++) {
+        uint8_t stream[128];
+        size_t length = 0;
+        for (int part = rand() % 3 + 1; part > 0; part--) {
+            for (int i = rand() % 12; i > 0; i--) {
+                stream[length++] = alphabet[rand() % sizeof(alphabet)];
+            }
+            const uint16_t arg = rand() % 2 ? 0x7EFF : alphabet[rand() % sizeof(alphabet)] << 8 | 0x7E;
+            const TF16PFrame frame = makeFrame(rand() % 2 ? 0x7E : ACK, arg, rand() % 2);
+            const size_t keep = rand() % 4 ? 10 : rand() % 10;
+            memcpy(stream + length, frame.bytes, keep);
+            length += keep;
+        }
+        TF16PFrame expected[12];
+        int count = 0;
+        for (size_t i = 0; i + 10 <= length;) {
+            if (validAt(stream + i)) {
+                memcpy(expected[count++].bytes, stream + i, 10);
+                i += 10;
+            } else {
+                i++;
+            }
+        }
+        TF16PParser parser;
+        TF16PFrame out[12];
+        EXPECT_EQ(feed(parser, stream, length, out), count);
+        for (int i = 0; i < count; i++) {
+            EXPECT(memcmp(out[i].bytes, expected[i].bytes, 10) == 0);
+        }
+        EXPECT(parser.getDiscardedBytes() <= length - count * 10);
+    }
+}
+}
+
+int main() {
+    testSingleFrame();
+    testSplitAcrossCalls();
+    testGarbageBeforeFrame();
+    testEmbeddedHeaderBytes();
+    testBadChecksum();
+    testHeaderInsideRejectedFrame();
+    testBackToBackFrames();
+    testReplayMatchesScan();
+    return testResult("TF16PParserTest");
+}
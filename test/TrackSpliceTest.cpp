@@ -0,0 +1,203 @@
+#include <memory>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "HostTest.h"
+#include "PcmRing.h"
+#include "Resampler.h"
+#include "StartCache.h"
+#include "TrackSlot.h"
+
+// 连续播放的衔接：把一张专辑切成几首，按 AudioPipeline 的做法经 TrackSlot 解码、采样率转换后写入 PCM 环。
+// 当前曲目剩余不到环的深度时在环满的空闲时间里预先打开下一首（交替从启动缓存恢复和从头打开），
+// 到末尾只交换两首，不补齐周期也不重置转换历史。从环中读出的样本必须与整张专辑作为一个文件播放时逐位相同。
+// 解码由 test/fake/minimp3.h 代替，帧头为自由比特率，定位索引不可用，恢复时按缓存记下的偏移直接跳转
+FakeMp3Track fakeMp3Tracks[FAKE_MP3_TRACKS];
+
+namespace {
+constexpr uint32_t ALBUM = 1500000;
+constexpr uint16_t FRAME = 1152;
+constexpr uint16_t INFO_BYTES = 417;
+// 与 AudioRing 相同的深度，剩余时长的门限同 AudioPipeline::RING_DEPTH_MS
+using Ring = PcmRing<576, 8>;
+constexpr uint32_t RING_DEPTH_MS = Ring::PERIOD_FRAMES * Ring::PERIOD_COUNT * 1000 / Resampler::OUTPUT_RATE;
+const uint8_t HEADER[4] = {0xFF, 0xFB, 0x00, 0x44};
+
+// 写出第 index 首：Info 帧（帧数与 LAME 延迟/填充）后接各音频帧，帧序号带曲目编号
+void writeTrack(const char* path, const uint8_t index, const FakeMp3Track& track) {
+    fakeMp3Tracks[index] = track;
+    const uint32_t frames = (track.delay + track.length + Mp3Decoder::DECODER_DELAY + FRAME - 1) / FRAME;
+    const uint32_t padding = frames * FRAME - track.delay - track.length;
+    std::vector<uint8_t> data(INFO_BYTES);
+    memcpy(data.data(), HEADER, sizeof(HEADER));
+    memcpy(data.data() + 36, "Info", 4);
+    data[43] = 0x0F;
+    data[44] = frames >> 24;
+    data[45] = frames >> 16;
+    data[46] = frames >> 8;
+    data[47] = frames;
+    uint8_t* lame = data.data() + 156;
+    memcpy(lame, "LAME3.100", 9);
+    lame[21] = track.delay >> 4;
+    lame[22] = (track.delay & 15) << 4 | padding >> 8;
+    lame[23] = padding & 0xFF;
+    for (uint32_t k = 0; k < frames; k++) {
+        const uint32_t number = k | static_cast<uint32_t>(index) << 24;
+        data.insert(data.end(), HEADER, HEADER + sizeof(HEADER));
+        data.insert(data.end(), reinterpret_cast<const uint8_t*>(&number),
+                    reinterpret_cast<const uint8_t*>(&number) + sizeof(number));
+    }
+    FILE* out = fopen(path, "wb");
+    EXPECT(out != nullptr);
+    if (out) {
+        EXPECT_EQ(fwrite(data.data(), 1, data.size(), out), data.size());
+        fclose(out);
+    }
+}
+
+// 管线的写入端：采样率转换 -> 环；环满时模仿 DMA 播出一个周期
+struct Output {
+    Ring ring;
+    Resampler resampler;
+    std::vector<uint32_t> played;
+
+    void playPeriod() {
+        if (const uint32_t* period = ring.acquireRead()) {
+            played.insert(played.end(), period, period + Ring::PERIOD_FRAMES);
+            ring.release();
+        }
+    }
+
+    void writeRing(const int16_t* samples, const uint32_t frames, const uint8_t channels) {
+        uint32_t written = 0;
+        while (written < frames) {
+            written += ring.write(samples + written * channels, frames - written, channels);
+            if (written < frames) {
+                playPeriod();
+            }
+        }
+    }
+
+    static void writeResampled(const int16_t* samples, const uint32_t frames, void* arg) {
+        static_cast<Output*>(arg)->writeRing(samples, frames, 2);
+    }
+
+    static void writeDecoded(const int16_t* samples, const uint32_t frames, const uint8_t channels, void* arg) {
+        auto* self = static_cast<Output*>(arg);
+        if (self->resampler.isActive()) {
+            self->resampler.process(samples, frames, channels, writeResampled, self);
+        } else {
+            self->writeRing(samples, frames, channels);
+        }
+    }
+};
+
+struct Counts {
+    uint32_t prepared = 0;
+    uint32_t resumed = 0;
+};
+
+// 依次连续播放 paths 中的曲目，第奇数次衔接的下一首先由启动缓存预解码开头；返回从环中播出的全部周期
+std::vector<uint32_t> playContinuous(const std::vector<std::string>& paths, const uint32_t hz, Counts& counts) {
+    static VorbisDecoder vorbis;
+    static StartCache cache;
+    const auto out = std::make_unique<Output>();
+    out->resampler.configure(hz);
+    const auto first = std::make_unique<TrackSlot>(vorbis, Output::writeDecoded, out.get());
+    const auto second = std::make_unique<TrackSlot>(vorbis, Output::writeDecoded, out.get());
+    TrackSlot* track = first.get();
+    TrackSlot* upcoming = second.get();
+    StartCache::Entry* entry = nullptr;
+    EXPECT(track->open(paths[0].c_str()) && track->activate());
+    size_t next = 1;
+    if (paths.size() > 2) {
+        cache.assign(0, paths[1].c_str());
+    }
+    while (true) {
+        // 环中放不下一帧时的空闲工作：剩余不到环的深度时预先打开下一首，否则预解码，都没有时播出一个周期
+        if (out->ring.freeFrames() < FRAME / 2) {
+            if (next < paths.size() && !upcoming->isOpen() && track->remainingMs() <= RING_DEPTH_MS) {
+                entry = cache.find(paths[next].c_str());
+                EXPECT(entry ? upcoming->resume(*entry) : upcoming->open(paths[next].c_str()));
+                counts.prepared++;
+                counts.resumed += entry != nullptr;
+            } else if (!cache.step()) {
+                out->playPeriod();
+            }
+            continue;
+        }
+        if (track->decode()) {
+            continue;
+        }
+        if (next == paths.size()) {
+            break;
+        }
+        // 末尾：下一首必须已在播完之前打开
+        EXPECT(upcoming->isOpen());
+        track->close();
+        std::swap(track, upcoming);
+        if (entry) {
+            Output::writeDecoded(entry->pcm, entry->frames, 2, out.get());
+            cache.consume(entry);
+            entry = nullptr;
+        }
+        EXPECT(track->activate());
+        next++;
+        if (next % 2 == 1 && next < paths.size()) {
+            cache.assign(0, paths[next].c_str());
+        }
+    }
+    track->close();
+    while (!out->ring.flush()) {
+        out->playPeriod();
+    }
+    while (out->ring.readyPeriods() > 0) {
+        out->playPeriod();
+    }
+    return out->played;
+}
+
+// 专辑切成 tracks 首，每首的编码器延迟随机；与整张专辑一个文件（曲目编号0）的输出逐位比较
+void testSplice(const uint32_t hz, const uint8_t tracks) {
+    srand(hz + tracks);
+    writeTrack("TrackSplice0.mp3", 0, {0, 1105, ALBUM, hz});
+    std::vector<std::string> paths;
+    uint32_t at = 0;
+    for (uint8_t i = 1; i <= tracks; i++) {
+        const uint32_t length = i == tracks ? ALBUM - at : ALBUM / tracks - 5000 + rand() % 10000;
+        const std::string path = "TrackSplice" + std::to_string(i) + ".mp3";
+        writeTrack(path.c_str(), i, {at, 576 + static_cast<uint32_t>(rand() % 1200), length, hz});
+        paths.push_back(path);
+        at += length;
+    }
+    Counts single;
+    const std::vector<uint32_t> whole = playContinuous({"TrackSplice0.mp3"}, hz, single);
+    Counts counts;
+    const std::vector<uint32_t> spliced = playContinuous(paths, hz, counts);
+    EXPECT_EQ(counts.prepared, tracks - 1u);
+    EXPECT(counts.resumed > 0);
+    EXPECT_EQ(spliced.size(), whole.size());
+    uint64_t mismatches = 0;
+    for (size_t i = 0; i < spliced.size() && i < whole.size(); i++) {
+        mismatches += spliced[i] != whole[i];
+    }
+    EXPECT_EQ(mismatches, 0);
+    // 不转换采样率时，整张专辑的输出本身就是样本的位置
+    if (hz == Resampler::OUTPUT_RATE) {
+        uint64_t wrong = 0;
+        for (uint32_t i = 0; i < ALBUM && i < whole.size(); i++) {
+            const auto sample = static_cast<uint16_t>(i & 0x7FFF);
+            wrong += whole[i] != (static_cast<uint32_t>(sample) << 16 | sample);
+        }
+        EXPECT_EQ(wrong, 0);
+    }
+    printf("%u Hz, %u tracks (%u from start cache): %zu frames, %llu mismatches\n", hz, tracks, counts.resumed,
+           spliced.size(), static_cast<unsigned long long>(mismatches));
+}
+} // namespace
+
+int main() {
+    testSplice(44100, 4);
+    testSplice(48000, 4);
+    return testResult("TrackSpliceTest");
+}
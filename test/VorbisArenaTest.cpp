@@ -0,0 +1,74 @@
+#include <string.h>
+#include "HostTest.h"
+#include "VorbisArena.h"
+
+namespace {
+void testAccounting() {
+    VorbisArena::reset();
+    void* a = vorbis_arena_malloc(100);
+    void* b = vorbis_arena_malloc(1000);
+    EXPECT(a != nullptr && b != nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 8, 0);
+    // 每块含8字节块头并按8字节对齐
+    EXPECT_EQ(VorbisArena::getUsed(), 112 + 1008);
+    vorbis_arena_free(a);
+    EXPECT_EQ(VorbisArena::getUsed(), 1008);
+    EXPECT(VorbisArena::getPeak() >= 1120);
+    vorbis_arena_free(b);
+    EXPECT_EQ(VorbisArena::getUsed(), 0);
+}
+
+void testCallocAndRealloc() {
+    VorbisArena::reset();
+    auto* bytes = static_cast<uint8_t*>(vorbis_arena_malloc(64));
+    memset(bytes, 0xAB, 64);
+    vorbis_arena_free(bytes);
+    auto* zeroed = static_cast<uint8_t*>(vorbis_arena_calloc(16, 4));
+    bool allZero = true;
+    for (int i = 0; i < 64; i++) {
+        allZero &= zeroed[i] == 0;
+    }
+    EXPECT(allZero);
+    for (int i = 0; i < 64; i++) {
+        zeroed[i] = static_cast<uint8_t>(i);
+    }
+    // 后面是空闲空间，原地扩大
+    auto* grown = static_cast<uint8_t*>(vorbis_arena_realloc(zeroed, 4096));
+    EXPECT(grown == zeroed);
+    // 后面被占用时移动并保留原内容
+    void* blocker = vorbis_arena_malloc(32);
+    auto* moved = static_cast<uint8_t*>(vorbis_arena_realloc(grown, 8192));
+    EXPECT(moved != nullptr && moved != grown);
+    bool kept = true;
+    for (int i = 0; i < 64; i++) {
+        kept &= moved[i] == i;
+    }
+    EXPECT(kept);
+    vorbis_arena_free(blocker);
+    vorbis_arena_free(moved);
+    EXPECT_EQ(VorbisArena::getUsed(), 0);
+}
+
+void testExhaustionAndMerge() {
+    VorbisArena::reset();
+    void* blocks[4];
+    for (void*& block : blocks) {
+        block = vorbis_arena_malloc(VorbisArena::SIZE / 4 - 8);
+        EXPECT(block != nullptr);
+    }
+    EXPECT(vorbis_arena_malloc(8) == nullptr);
+    // 相邻的空闲块在分配时合并
+    vorbis_arena_free(blocks[1]);
+    vorbis_arena_free(blocks[2]);
+    EXPECT(vorbis_arena_malloc(VorbisArena::SIZE / 2 - 8) != nullptr);
+    VorbisArena::reset();
+    EXPECT(vorbis_arena_malloc(VorbisArena::SIZE - 8) != nullptr);
+}
+}
+
+int main() {
+    testAccounting();
+    testCallocAndRealloc();
+    testExhaustionAndMerge();
+    return testResult("VorbisArenaTest");
+}
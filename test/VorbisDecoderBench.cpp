@@ -0,0 +1,63 @@
+#include <chrono>
+#include <stdlib.h>
+#include "HostTest.h"
+#include "VorbisArena.h"
+#include "VorbisDecoder.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Vorbis 解码基准：经 FileReader 和 VorbisDecoder 完整解码命令行给出的 .ogg 文件，
+// 报告每次 decode()（一段输出）的平均耗时与周期数、实时倍数，以及 VorbisArena 的峰值占用
+namespace {
+uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+}
+
+int main(const int argc, char** argv) {
+    if (argc < 2) {
+        printf("usage: VorbisDecoderBench file.ogg\n");
+        return 2;
+    }
+    static FileReader reader;
+    static VorbisDecoder decoder;
+    EXPECT(reader.open(argv[1]));
+    EXPECT(decoder.start(reader));
+    const size_t headerPeak = VorbisArena::getPeak();
+
+    uint64_t calls = 0;
+    uint64_t frames = 0;
+    const uint64_t startCycles = cycles();
+    const auto start = std::chrono::steady_clock::now();
+    while (true) {
+        const uint32_t count = decoder.decode();
+        if (count == 0) {
+            break;
+        }
+        calls++;
+        frames += count;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t elapsedCycles = cycles() - startCycles;
+    const double audioSeconds = decoder.getSampleRate() ? static_cast<double>(frames) / decoder.getSampleRate() : 0;
+    printf("%s: %u Hz, %u ch, %u kbps, %.1f s\n", argv[1], decoder.getSampleRate(), decoder.getChannels(),
+           decoder.getBitrateKbps(), audioSeconds);
+    printf("decode %.1fx realtime, %.2f us/frame (%llu frames of %.0f samples)", audioSeconds / seconds,
+           calls ? seconds * 1e6 / calls : 0.0, static_cast<unsigned long long>(calls),
+           calls ? static_cast<double>(frames) / calls : 0.0);
+    if (elapsedCycles && calls) {
+        printf(", %.0f cycles/frame", static_cast<double>(elapsedCycles) / calls);
+    }
+    printf("\narena peak %zu B after headers, %zu B overall, limit %zu B\n", headerPeak, VorbisArena::getPeak(),
+           VorbisArena::SIZE);
+    decoder.finish();
+    EXPECT(frames > 0);
+    EXPECT(VorbisArena::getPeak() <= VorbisArena::SIZE);
+    EXPECT_EQ(VorbisArena::getUsed(), 0);
+    return testResult("VorbisDecoderBench");
+}
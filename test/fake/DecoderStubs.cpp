@@ -0,0 +1,37 @@
+#include "FlacDecoder.h"
+#include "VorbisDecoder.h"
+
+// 只测 MP3 的主机测试链接的 FLAC 与 Vorbis 解码器：打开总是失败，不会产生样本
+FlacDecoder::~FlacDecoder() = default;
+
+bool FlacDecoder::start(FileReader&, Sink, void*) {
+    return false;
+}
+
+uint32_t FlacDecoder::decode() {
+    return 0;
+}
+
+bool FlacDecoder::seek(uint64_t) {
+    return false;
+}
+
+void FlacDecoder::finish() {
+}
+
+VorbisDecoder::~VorbisDecoder() = default;
+
+bool VorbisDecoder::start(FileReader&) {
+    return false;
+}
+
+uint32_t VorbisDecoder::decode() {
+    return 0;
+}
+
+bool VorbisDecoder::seek(uint32_t) {
+    return false;
+}
+
+void VorbisDecoder::finish() {
+}
@@ -0,0 +1,12 @@
+#ifndef FAKE_IVORBISFILE_H
+#define FAKE_IVORBISFILE_H
+#include <stdint.h>
+
+// Tremor 头文件的替身，只声明 VorbisDecoder.h 用到的类型；VorbisDecoder 由 DecoderStubs.cpp 中总是失败的空实现代替
+typedef int64_t ogg_int64_t;
+
+typedef struct {
+    int unused;
+} OggVorbis_File;
+
+#endif // FAKE_IVORBISFILE_H
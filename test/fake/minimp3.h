@@ -0,0 +1,93 @@
+#ifndef FAKE_MINIMP3_H
+#define FAKE_MINIMP3_H
+#include <stdint.h>
+#include <string.h>
+
+// minimp3 的替身，供 GaplessTest 与 TrackSpliceTest 使用：不做真正的解码，每帧输出的样本值就是该样本在整张专辑中的位置（取低15位），
+// 编码器延迟之前、曲目长度之后的样本输出 -32768。帧只有4字节帧头加4字节的帧序号 k，
+// 序号最高位置1的帧模拟比特池不足：解码器初始化后的第一帧遇到它时不出样本；第24–30位为曲目编号。
+// 第 k 帧的第 s 个样本对应编码器输出的第 k * 1152 + s - 529 个样本（minimp3 的解码延迟）
+#define MINIMP3_MAX_SAMPLES_PER_FRAME (1152 * 2)
+
+typedef struct {
+    int frame_bytes, frame_offset, channels, hz, layer, bitrate_kbps;
+} mp3dec_frame_info_t;
+
+typedef struct {
+    int decoded;
+} mp3dec_t;
+
+typedef int16_t mp3d_sample_t;
+
+// 各曲目在专辑中的起点、编码器延迟、长度与采样率（0 为 44.1kHz），按帧中的曲目编号选取，由测试设置
+struct FakeMp3Track {
+    uint32_t albumStart;
+    uint32_t delay;
+    uint32_t length;
+    uint32_t hz;
+};
+
+constexpr uint8_t FAKE_MP3_TRACKS = 128;
+extern FakeMp3Track fakeMp3Tracks[FAKE_MP3_TRACKS];
+
+#ifdef MINIMP3_IMPLEMENTATION
+#define HDR_IS_MONO(h) (((h[3]) & 0xC0) == 0xC0)
+#define HDR_TEST_MPEG1(h) ((h[1]) & 0x8)
+
+static int hdr_valid(const uint8_t* h) {
+    return h[0] == 0xff && (h[1] & 0xE0) == 0xE0;
+}
+
+static unsigned hdr_frame_samples(const uint8_t* h) {
+    return HDR_TEST_MPEG1(h) ? 1152 : 576;
+}
+
+void mp3dec_init(mp3dec_t* dec) {
+    dec->decoded = 0;
+}
+
+// Xing/Info 帧固定417字节，输出1152个 -32768（解码器应当丢弃整帧）
+int mp3dec_decode_frame(mp3dec_t* dec, const uint8_t* mp3, const int bytes, mp3d_sample_t* pcm,
+                        mp3dec_frame_info_t* info) {
+    int i = 0;
+    while (i + 8 <= bytes && !hdr_valid(mp3 + i)) {
+        i++;
+    }
+    if (i + 8 > bytes) {
+        info->frame_bytes = 0;
+        return 0;
+    }
+    const uint8_t* h = mp3 + i;
+    info->channels = 1;
+    info->hz = 44100;
+    info->layer = 3;
+    info->bitrate_kbps = 128;
+    if (bytes - i >= 40 && memcmp(h + 36, "Info", 4) == 0) {
+        info->frame_bytes = i + 417;
+        for (int s = 0; s < 1152; s++) {
+            pcm[s] = -32768;
+        }
+        return 1152;
+    }
+    info->frame_bytes = i + 8;
+    uint32_t k;
+    memcpy(&k, h + 4, 4);
+    const FakeMp3Track& track = fakeMp3Tracks[k >> 24 & 0x7F];
+    info->hz = track.hz ? track.hz : 44100;
+    const bool first = dec->decoded == 0;
+    dec->decoded = 1;
+    if (first && (k & 0x80000000u)) {
+        return 0;
+    }
+    k &= 0xFFFFFF;
+    for (uint32_t s = 0; s < 1152; s++) {
+        const int64_t encoded = static_cast<int64_t>(k) * 1152 + s - 529;
+        pcm[s] = encoded < track.delay || encoded >= track.delay + track.length
+                     ? -32768
+                     : static_cast<int16_t>((track.albumStart + encoded - track.delay) & 0x7FFF);
+    }
+    return 1152;
+}
+#endif
+
+#endif // FAKE_MINIMP3_H
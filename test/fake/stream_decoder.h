@@ -0,0 +1,22 @@
+#ifndef FAKE_STREAM_DECODER_H
+#define FAKE_STREAM_DECODER_H
+#include <stdint.h>
+#include <stddef.h>
+
+// libFLAC 解码器头文件的替身，只声明 FlacDecoder.h 用到的类型，供不需要真正解码 FLAC 的主机测试编译
+// TrackSlot/StartCache；FlacDecoder 本身由 DecoderStubs.cpp 中总是失败的空实现代替
+typedef int FLAC__bool;
+typedef int32_t FLAC__int32;
+typedef uint8_t FLAC__byte;
+typedef uint64_t FLAC__uint64;
+typedef struct FLAC__StreamDecoder FLAC__StreamDecoder;
+typedef struct FLAC__Frame FLAC__Frame;
+typedef struct FLAC__StreamMetadata FLAC__StreamMetadata;
+typedef enum { FLAC__STREAM_DECODER_READ_STATUS_CONTINUE } FLAC__StreamDecoderReadStatus;
+typedef enum { FLAC__STREAM_DECODER_SEEK_STATUS_OK } FLAC__StreamDecoderSeekStatus;
+typedef enum { FLAC__STREAM_DECODER_TELL_STATUS_OK } FLAC__StreamDecoderTellStatus;
+typedef enum { FLAC__STREAM_DECODER_LENGTH_STATUS_OK } FLAC__StreamDecoderLengthStatus;
+typedef enum { FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE } FLAC__StreamDecoderWriteStatus;
+typedef enum { FLAC__STREAM_DECODER_ERROR_STATUS_LOST_SYNC } FLAC__StreamDecoderErrorStatus;
+
+#endif // FAKE_STREAM_DECODER_H
@@ -0,0 +1,14 @@
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+#include <stdint.h>
+
+// 把虚拟时钟推进 us 微秒，期间到期的闹钟依次执行
+void host_advance_us(uint64_t us);
+
+// 把虚拟时钟推进到下一个闹钟并执行它，没有闹钟时返回 false
+bool host_run_next_alarm();
+
+// 取消全部闹钟，时钟不回退
+void host_clear_alarms();
+
+#endif // HOST_HAL_H
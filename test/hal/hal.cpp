@@ -0,0 +1,120 @@
+#include "HostHal.h"
+#include "pico/stdlib.h"
+#include <map>
+#include <utility>
+
+namespace {
+struct Alarm {
+    alarm_id_t id;
+    alarm_callback_t callback;
+    void* userData;
+};
+
+uint64_t now = 0;
+alarm_id_t lastId = 0;
+// 键为（到期时间，序号），同一时刻的闹钟按添加顺序执行
+std::map<std::pair<uint64_t, alarm_id_t>, Alarm> alarms;
+
+void fire(const uint64_t at, const Alarm alarm) {
+    now = at;
+    const int64_t again = alarm.callback(alarm.id, alarm.userData);
+    if (again != 0) {
+        const uint64_t next = again > 0 ? now + again : at - again;
+        alarms.emplace(std::make_pair(next, ++lastId), Alarm{alarm.id, alarm.callback, alarm.userData});
+    }
+}
+}
+
+uart_inst_t uartInstances[2] = {{0}, {1}};
+uart_inst_t* const uart0 = &uartInstances[0];
+uart_inst_t* const uart1 = &uartInstances[1];
+
+uint64_t time_us_64() {
+    return now;
+}
+
+uint32_t time_us_32() {
+    return static_cast<uint32_t>(now);
+}
+
+void sleep_us(const uint64_t us) {
+    host_advance_us(us);
+}
+
+void sleep_ms(const uint32_t ms) {
+    host_advance_us(static_cast<uint64_t>(ms) * 1000);
+}
+
+void busy_wait_us(const uint64_t us) {
+    host_advance_us(us);
+}
+
+alarm_id_t add_alarm_in_us(const uint64_t us, const alarm_callback_t callback, void* userData, bool) {
+    const alarm_id_t id = ++lastId;
+    alarms.emplace(std::make_pair(now + us, id), Alarm{id, callback, userData});
+    return id;
+}
+
+alarm_id_t add_alarm_in_ms(const uint32_t ms, const alarm_callback_t callback, void* userData, const bool fireIfPast) {
+    return add_alarm_in_us(static_cast<uint64_t>(ms) * 1000, callback, userData, fireIfPast);
+}
+
+bool cancel_alarm(const alarm_id_t id) {
+    for (auto it = alarms.begin(); it != alarms.end(); ++it) {
+        if (it->second.id == id) {
+            alarms.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void host_advance_us(const uint64_t us) {
+    const uint64_t until = now + us;
+    while (!alarms.empty() && alarms.begin()->first.first <= until) {
+        const auto it = alarms.begin();
+        const uint64_t at = it->first.first;
+        const Alarm alarm = it->second;
+        alarms.erase(it);
+        fire(at, alarm);
+    }
+    now = until;
+}
+
+bool host_run_next_alarm() {
+    if (alarms.empty()) {
+        return false;
+    }
+    const auto it = alarms.begin();
+    const uint64_t at = it->first.first < now ? now : it->first.first;
+    const Alarm alarm = it->second;
+    alarms.erase(it);
+    fire(at, alarm);
+    return true;
+}
+
+void host_clear_alarms() {
+    alarms.clear();
+}
+
+uint uart_init(uart_inst_t*, const uint baudrate) {
+    return baudrate;
+}
+
+uint uart_get_index(uart_inst_t* uart) {
+    return uart->index;
+}
+
+void uart_write_blocking(uart_inst_t*, const uint8_t*, size_t) {
+}
+
+bool uart_is_readable(uart_inst_t*) {
+    return false;
+}
+
+char uart_getc(uart_inst_t*) {
+    return 0;
+}
+
+void uart_set_irq_enables(uart_inst_t*, bool, bool) {
+}
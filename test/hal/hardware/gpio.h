@@ -0,0 +1,26 @@
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+enum gpio_function {
+    GPIO_FUNC_UART = 2
+};
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+inline void gpio_init(uint) {
+}
+
+inline void gpio_set_dir(uint, bool) {
+}
+
+inline void gpio_put(uint, bool) {
+}
+
+inline void gpio_set_function(uint, gpio_function) {
+}
+
+#endif // HOST_HARDWARE_GPIO_H
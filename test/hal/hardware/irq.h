@@ -0,0 +1,16 @@
+#ifndef HOST_HARDWARE_IRQ_H
+#define HOST_HARDWARE_IRQ_H
+#include "hardware/gpio.h"
+
+typedef void (*irq_handler_t)();
+
+#define UART0_IRQ 33
+#define UART1_IRQ 34
+
+inline void irq_set_exclusive_handler(uint, irq_handler_t) {
+}
+
+inline void irq_set_enabled(uint, bool) {
+}
+
+#endif // HOST_HARDWARE_IRQ_H
@@ -0,0 +1,22 @@
+#ifndef HOST_HARDWARE_UART_H
+#define HOST_HARDWARE_UART_H
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/gpio.h"
+
+// 串口替身：写出的字节丢弃，接收端永远为空。驱动在主机上只通过 attach() 接到模拟器
+struct uart_inst_t {
+    uint index;
+};
+
+extern uart_inst_t* const uart0;
+extern uart_inst_t* const uart1;
+
+uint uart_init(uart_inst_t* uart, uint baudrate);
+uint uart_get_index(uart_inst_t* uart);
+void uart_write_blocking(uart_inst_t* uart, const uint8_t* data, size_t length);
+bool uart_is_readable(uart_inst_t* uart);
+char uart_getc(uart_inst_t* uart);
+void uart_set_irq_enables(uart_inst_t* uart, bool rxEnabled, bool txEnabled);
+
+#endif // HOST_HARDWARE_UART_H
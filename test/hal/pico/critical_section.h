@@ -0,0 +1,21 @@
+#ifndef HOST_PICO_CRITICAL_SECTION_H
+#define HOST_PICO_CRITICAL_SECTION_H
+#include <mutex>
+
+// 与 SDK 一致不可重入；主机上用互斥锁代替自旋锁加关中断
+struct critical_section_t {
+    std::mutex mutex;
+};
+
+inline void critical_section_init(critical_section_t*) {
+}
+
+inline void critical_section_enter_blocking(critical_section_t* section) {
+    section->mutex.lock();
+}
+
+inline void critical_section_exit(critical_section_t* section) {
+    section->mutex.unlock();
+}
+
+#endif // HOST_PICO_CRITICAL_SECTION_H
@@ -0,0 +1,11 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+// 主机测试用的 Pico SDK 替身：只提供驱动和模拟器用到的部分
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/uart.h"
+
+#endif // HOST_PICO_STDLIB_H
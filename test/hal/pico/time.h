@@ -0,0 +1,20 @@
+#ifndef HOST_PICO_TIME_H
+#define HOST_PICO_TIME_H
+#include <stdint.h>
+
+// 虚拟时钟：只在 sleep_ms()/sleep_us() 或 host_advance_us() 时前进，到期的闹钟按时间顺序在调用线程中执行
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void* userData);
+
+uint64_t time_us_64();
+uint32_t time_us_32();
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void busy_wait_us(uint64_t us);
+
+// 回调返回0不再触发，>0 为从现在起的下次间隔，<0 为从上次到期时间起的间隔
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void* userData, bool fireIfPast);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void* userData, bool fireIfPast);
+bool cancel_alarm(alarm_id_t id);
+
+#endif // HOST_PICO_TIME_H